@@ -0,0 +1,129 @@
+// ======================================================================
+// FILE:        Affinity.cpp
+//
+// DESCRIPTION: This file contains the CPU placement helpers shared by
+//              the worker pools.
+// ======================================================================
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "Affinity.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <pthread.h>
+#include <sched.h>
+
+using namespace std;
+
+vector<int> Affinity::allowedCpus ( void )
+{
+	vector<int> cpus;
+
+	cpu_set_t set;
+	CPU_ZERO ( &set );
+	if ( sched_getaffinity ( 0, sizeof set, &set ) == 0 )
+		for ( int cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+			if ( CPU_ISSET ( cpu, &set ) )
+				cpus.push_back ( cpu );
+
+	if ( cpus.empty() )
+		for ( unsigned cpu = 0; cpu < max ( 1u, thread::hardware_concurrency() ); ++cpu )
+			cpus.push_back ( cpu );
+	return cpus;
+}
+
+// CPUs granted by a quota and a period, rounded up; 0 if unlimited
+static int cpusFromQuota ( long long quota, long long period )
+{
+	if ( quota <= 0 || period <= 0 )
+		return 0;
+	return static_cast<int> ( ( quota + period - 1 ) / period );
+}
+
+// The tightest cpu.max limit from the process's cgroup v2 up to the root
+static int cgroupV2Limit ( void )
+{
+	ifstream membership ( "/proc/self/cgroup" );
+	string line, path;
+	while ( getline ( membership, line ) )
+		if ( line.compare ( 0, 3, "0::" ) == 0 )
+			path = line.substr ( 3 );
+
+	int limit = 0;
+	for ( ;; )
+	{
+		ifstream file ( "/sys/fs/cgroup" + path + "/cpu.max" );
+		string quota;
+		long long period;
+		if ( file >> quota >> period && quota != "max" )
+		{
+			int cpus = cpusFromQuota ( atoll ( quota.c_str() ), period );
+			if ( cpus > 0 && ( limit == 0 || cpus < limit ) )
+				limit = cpus;
+		}
+
+		if ( path.empty() || path == "/" )
+			return limit;
+		size_t slash = path.find_last_of ( '/' );
+		path = slash == 0 || slash == string::npos ? "" : path.substr ( 0, slash );
+	}
+}
+
+// The cfs quota of the cgroup v1 cpu controller mounted at the usual places
+static int cgroupV1Limit ( void )
+{
+	static const char* const MOUNTS[] = { "/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct" };
+
+	for ( const char* mount : MOUNTS )
+	{
+		ifstream quotaFile  ( string ( mount ) + "/cpu.cfs_quota_us" );
+		ifstream periodFile ( string ( mount ) + "/cpu.cfs_period_us" );
+		long long quota, period;
+		if ( quotaFile >> quota && periodFile >> period )
+			return cpusFromQuota ( quota, period );
+	}
+	return 0;
+}
+
+int Affinity::cgroupCpuLimit ( void )
+{
+	int limit = cgroupV2Limit();
+	return limit > 0 ? limit : cgroupV1Limit();
+}
+
+int Affinity::defaultThreads ( void )
+{
+	int cpus  = static_cast<int> ( allowedCpus().size() );
+	int limit = cgroupCpuLimit();
+	return max ( 1, limit > 0 ? min ( cpus, limit ) : cpus );
+}
+
+Affinity::Placement Affinity::placement ( void )
+{
+	return Placement { allowedCpus(), cgroupCpuLimit() };
+}
+
+bool Affinity::pinWorker ( const Placement& placement, int worker, int workers )
+{
+	const vector<int>& cpus = placement.cpus;
+	if ( workers > static_cast<int> ( cpus.size() ) || worker < 0 || worker >= workers )
+		return false;
+
+	// A quota smaller than the CPU set shares the set with other
+	// processes; pinning every one of them to its first CPUs would pile
+	// them up there
+	if ( placement.limit > 0 && placement.limit < static_cast<int> ( cpus.size() ) )
+		return false;
+
+	cpu_set_t set;
+	CPU_ZERO ( &set );
+	CPU_SET ( cpus[worker], &set );
+	return pthread_setaffinity_np ( pthread_self(), sizeof set, &set ) == 0;
+}
@@ -0,0 +1,77 @@
+// ======================================================================
+// FILE:        Affinity.hpp
+//
+// DESCRIPTION: This file contains the CPU placement helpers shared by
+//              the worker pools (the server, the C API, the generator,
+//              the regret and stress modes). A game takes microseconds,
+//              so a worker that migrates between cores, or that writes
+//              next to another worker's data, loses more to cache
+//              traffic than it spends playing.
+//
+// NOTES:       - defaultThreads() counts the CPUs the process may run on
+//                (its affinity mask, which taskset and cpuset cgroups
+//                narrow) and caps them by the CPU time its cgroup grants
+//                (cpu.max in cgroup v2, cpu.cfs_quota_us in v1), rounded
+//                up. std::thread::hardware_concurrency() sees neither.
+//
+//              - Pinning is opt-in (--pin on the subcommands that start
+//                pools) and the C API never pins. pinWorker() binds
+//                worker w of a pool to the w-th allowed CPU, so two
+//                pinned pools running at once, in one process or in two,
+//                pile up on the same low CPUs; pin only a pool that has
+//                the machine to itself. It does not pin a pool with more
+//                workers than allowed CPUs, or a process whose cgroup
+//                quota is smaller than its CPU set, which shares the set
+//                with others; those are left to the scheduler.
+//
+//              - The CPU set and the cgroup limit are read once per pool
+//                into a Placement, which every worker is handed, rather
+//                than by each worker from /proc and /sys.
+//
+//              - Workers build their Players and buffers after pinning,
+//                so the memory is first touched, and placed, on their
+//                own core's node. The engine allocates nothing per game
+//                (see Player.hpp), and malloc already gives each thread
+//                its own arena, so no separate allocator is needed.
+//
+//              - Data written by different workers should be at least
+//                CACHE_LINE bytes apart: hand out work in contiguous
+//                blocks rather than striped indices, and align per-worker
+//                counters with alignas ( CACHE_LINE ).
+// ======================================================================
+
+#ifndef AFFINITY_LOCK
+#define AFFINITY_LOCK
+
+#include <cstddef>
+#include <vector>
+
+namespace Affinity
+{
+	const size_t CACHE_LINE = 64;
+
+	// The CPUs the process may run on, in increasing order
+	std::vector<int>	allowedCpus		( void );
+
+	// Whole CPUs of time the cgroup grants, rounded up; 0 if unlimited
+	int		cgroupCpuLimit	( void );
+
+	// Worker threads a pool should start when not told otherwise
+	int		defaultThreads	( void );
+
+	// Where a pool's workers may run, read once for the whole pool
+	struct Placement
+	{
+		std::vector<int>	cpus;		// allowedCpus()
+		int					limit;		// cgroupCpuLimit()
+	};
+
+	Placement	placement	( void );
+
+	// Binds the calling thread to the CPU for worker 'worker' of a pool
+	// of 'workers'. Returns false, without binding, where the notes above
+	// say not to pin or if the binding fails.
+	bool	pinWorker		( const Placement& placement, int worker, int workers );
+}
+
+#endif /* AFFINITY_LOCK */
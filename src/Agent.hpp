@@ -23,6 +23,9 @@
 #ifndef AGENT_LOCK
 #define AGENT_LOCK
 
+#include <cstddef>
+#include <cstdint>
+
 class Agent
 {
 public:
@@ -48,6 +51,31 @@ public:
 		bool scream
 		
 	) = 0;
+	
+	// Returns a heap-allocated copy of this agent, including whatever it
+	// remembers about the current game. Used to copy a World.
+	virtual Agent* clone ( void ) const = 0;
+	
+	// True if the agent always answers the same percepts with the same
+	// actions. Results can then be reused across identical worlds.
+	virtual bool isDeterministic ( void ) const { return false; }
+	
+	// True if, in addition, the agent scores the same on a board and its
+	// mirror image along the diagonal through the start.
+	virtual bool isSymmetryAware ( void ) const { return false; }
+	
+	// Forgets the current game so the agent can play a new one, keeping
+	// whatever storage it already has. 'seed' seeds any randomness the
+	// agent uses. An agent that remembers nothing between turns can keep
+	// the default, which does nothing.
+	virtual void reset ( uint64_t /*seed*/ ) {}
+	
+	// Identifies the agent's code for the result cache (see
+	// ResultCache.hpp): a score cached under one id is only reused under
+	// the same id. NULL, the default, keeps the agent out of the cache.
+	virtual const char* buildId ( void ) const { return NULL; }
+	
+	virtual ~Agent() {}
 };
 
 #endif
\ No newline at end of file
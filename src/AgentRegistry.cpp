@@ -0,0 +1,51 @@
+// ======================================================================
+// FILE:        AgentRegistry.cpp
+//
+// DESCRIPTION: This file contains the agent registry, which creates
+//              agents by name.
+// ======================================================================
+
+#include "AgentRegistry.hpp"
+#include "MyAI.hpp"
+#include "RandomAI.hpp"
+#include "ScoutAI.hpp"
+
+using namespace std;
+
+namespace
+{
+	struct Registration
+	{
+		const char*	name;
+		Agent*		( *make ) ( void );
+	};
+
+	const Registration registrations[] =
+	{
+		{ "myai",   [] () -> Agent* { return new MyAI(); } },
+		{ "random", [] () -> Agent* { return new RandomAI(); } },
+#ifdef WW_COROUTINES
+		{ "scout",  [] () -> Agent* { return new ScoutAI(); } },
+#endif
+	};
+}
+
+Agent* AgentRegistry::make ( const string& name )
+{
+	for ( const Registration& registration : registrations )
+		if ( name == registration.name )
+			return registration.make();
+	return NULL;
+}
+
+const vector<string>& AgentRegistry::names ( void )
+{
+	static const vector<string> all = []
+	{
+		vector<string> list;
+		for ( const Registration& registration : registrations )
+			list.push_back ( registration.name );
+		return list;
+	} ();
+	return all;
+}
@@ -0,0 +1,34 @@
+// ======================================================================
+// FILE:        AgentRegistry.hpp
+//
+// DESCRIPTION: This file contains the agent registry, which creates
+//              agents by name for callers that are not driven by the
+//              command line flags (the server, the C API).
+//
+// NOTES:       - Registered names: "myai" and "random", and "scout" (see
+//                ScoutAI.hpp) when built with coroutines. The ManualAI is
+//                left out on purpose; it needs a terminal.
+//
+//              - A new agent is seeded with 0; reset it with
+//                World::agentSeed() of the game's seed before each game
+//                to play exactly as a World with that seed would.
+// ======================================================================
+
+#ifndef AGENTREGISTRY_LOCK
+#define AGENTREGISTRY_LOCK
+
+#include <string>
+#include <vector>
+#include "Agent.hpp"
+
+namespace AgentRegistry
+{
+	// Returns a heap-allocated agent registered under 'name', or NULL if
+	// there is none
+	Agent*	make	( const std::string& name );
+
+	// The registered names, in a fixed order
+	const std::vector<std::string>&	names	( void );
+}
+
+#endif /* AGENTREGISTRY_LOCK */
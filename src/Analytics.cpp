@@ -0,0 +1,81 @@
+// ======================================================================
+// FILE:        Analytics.cpp
+//
+// DESCRIPTION: This file contains the merging and the file format of
+//              SpatialStats.
+// ======================================================================
+
+#include "Analytics.hpp"
+
+#include <string>
+
+using namespace std;
+
+namespace
+{
+	typedef uint64_t Grid[SpatialStats::MAX][SpatialStats::MAX];
+
+	struct Array
+	{
+		const char*	key;
+		Grid SpatialStats::*	grid;
+	};
+
+	const Array ARRAYS[] =
+	{
+		{ "VISITS:",        &SpatialStats::visits },
+		{ "PIT_DEATHS:",    &SpatialStats::pitDeaths },
+		{ "WUMPUS_DEATHS:", &SpatialStats::wumpusDeaths },
+		{ "BUMPS:",         &SpatialStats::bumps },
+		{ "WASTED_ARROWS:", &SpatialStats::wastedArrows },
+	};
+}
+
+void SpatialStats::merge ( const SpatialStats& other )
+{
+	games += other.games;
+	for ( const Array& array : ARRAYS )
+		for ( int c = 0; c < MAX; ++c )
+			for ( int r = 0; r < MAX; ++r )
+				( this->*array.grid )[c][r] += ( other.*array.grid )[c][r];
+}
+
+void SpatialStats::write ( ostream& out ) const
+{
+	out << "ANALYTICS\n";
+	out << "DIMENSION: " << MAX << '\n';
+	out << "GAMES: " << games << '\n';
+	for ( const Array& array : ARRAYS )
+	{
+		out << array.key;
+		for ( int r = 0; r < MAX; ++r )
+			for ( int c = 0; c < MAX; ++c )
+				out << ' ' << ( this->*array.grid )[c][r];
+		out << '\n';
+	}
+}
+
+bool SpatialStats::read ( istream& in )
+{
+	string	key;
+	int		dimension;
+
+	*this = SpatialStats();
+	if ( !( in >> key ) || key != "ANALYTICS" )
+		return false;
+	if ( !( in >> key >> dimension ) || key != "DIMENSION:" || dimension != MAX )
+		return false;
+	if ( !( in >> key >> games ) || key != "GAMES:" )
+		return false;
+
+	for ( const Array& array : ARRAYS )
+	{
+		if ( !( in >> key ) || key != array.key )
+			return false;
+		for ( int r = 0; r < MAX; ++r )
+			for ( int c = 0; c < MAX; ++c )
+				if ( !( in >> ( this->*array.grid )[c][r] ) )
+					return false;
+	}
+	return true;
+}
@@ -0,0 +1,82 @@
+// ======================================================================
+// FILE:        Analytics.hpp
+//
+// DESCRIPTION: This file contains SpatialStats, the per-cell counters
+//              of where agents go and where things go wrong across a
+//              suite: how often each cell is entered, where agents fall
+//              into pits or walk into the wumpus, where they bump into
+//              walls and where they waste their arrow.
+//
+// NOTES:       - The engines record into a SpatialStats when given one
+//                (see World::setAnalytics, playFixed and Player). The
+//                counters are plain integers and every method is inline,
+//                so recording costs a few additions per action. A
+//                SpatialStats is not thread-safe: each thread keeps its
+//                own and they are merged once the threads are done, so
+//                no game ever waits on a lock or an atomic.
+//
+//              - Cells are indexed [col][row] like the World's board,
+//                for boards up to MAX_DIMENSION on a side. An entry of
+//                the run counts 'weight' games, so a deduplicated world
+//                counts once per copy.
+//
+//              - A visit is a move into a cell, the start counting as
+//                one visit per game. A bump is counted at the cell the
+//                agent bumped from, and a wasted arrow at the cell it
+//                was shot from when it hit nothing.
+//
+//              - The analytics file format is:
+//
+//                  ANALYTICS
+//                  DIMENSION: <MAX_DIMENSION>
+//                  GAMES: <games>
+//                  VISITS: <count> ...
+//                  PIT_DEATHS: <count> ...
+//                  WUMPUS_DEATHS: <count> ...
+//                  BUMPS: <count> ...
+//                  WASTED_ARROWS: <count> ...
+//
+//                Each array line holds DIMENSION x DIMENSION counts, row
+//                by row from row 0, so cell (c, r) is the count at
+//                r * DIMENSION + c. Files from several runs or shards
+//                merge exactly (Wumpus_World merge).
+// ======================================================================
+
+#ifndef ANALYTICS_LOCK
+#define ANALYTICS_LOCK
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include "WorldDescription.hpp"
+
+struct SpatialStats
+{
+	static const int MAX = WorldDescription::MAX_DIMENSION;
+
+	uint64_t	weight = 1;		// Games each recorded game stands for
+
+	uint64_t	games = 0;
+	uint64_t	visits       [MAX][MAX] = {};
+	uint64_t	pitDeaths    [MAX][MAX] = {};
+	uint64_t	wumpusDeaths [MAX][MAX] = {};
+	uint64_t	bumps        [MAX][MAX] = {};
+	uint64_t	wastedArrows [MAX][MAX] = {};
+
+	// Recording, called by the engines
+	void	startGame	( void )					{ games += weight; visits[0][0] += weight; }
+	void	visit		( int c, int r )			{ visits[c][r] += weight; }
+	void	bump		( int c, int r )			{ bumps[c][r] += weight; }
+	void	died		( int c, int r, bool pit )	{ ( pit ? pitDeaths : wumpusDeaths )[c][r] += weight; }
+	void	missed		( int c, int r )			{ wastedArrows[c][r] += weight; }
+
+	void	merge		( const SpatialStats& other );
+	void	reset		( void ) { *this = SpatialStats(); }
+
+	// Write or read the analytics file format; read() returns false if
+	// the header, the games or an array is missing or malformed
+	void	write		( std::ostream& out ) const;
+	bool	read		( std::istream& in );
+};
+
+#endif /* ANALYTICS_LOCK */
@@ -0,0 +1,364 @@
+// ======================================================================
+// FILE:        CApi.cpp
+//
+// DESCRIPTION: This file contains the C interface declared in wumpus.h.
+//              It is a thin layer over WorldDescription, AgentRegistry
+//              and Player that turns C callbacks into an Agent and C++
+//              exceptions into status codes.
+// ======================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Affinity.hpp"
+#include "AgentRegistry.hpp"
+#include "Player.hpp"
+#include "WorldDescription.hpp"
+#include "wumpus.h"
+
+using namespace std;
+
+struct wumpus_suite
+{
+	vector<WorldDescription>	worlds;
+};
+
+namespace
+{
+	// An Agent that forwards to caller-supplied callbacks. The state for
+	// a game is created by reset() and destroyed by the next reset() or
+	// the destructor.
+	class CallbackAgent : public Agent
+	{
+	public:
+
+		explicit CallbackAgent ( const wumpus_agent_callbacks& callbacks ) : callbacks ( callbacks ) {}
+
+		~CallbackAgent ( void )
+		{
+			release();
+		}
+
+		Action getAction ( bool stench, bool breeze, bool glitter, bool bump, bool scream )
+		{
+			if ( !live )
+				throw runtime_error ( "callback agent used before reset" );
+
+			wumpus_percepts percepts = { stench, breeze, glitter, bump, scream };
+			int action = callbacks.act ( state, &percepts );
+			if ( action < WUMPUS_TURN_LEFT || action > WUMPUS_CLIMB )
+				throw runtime_error ( "callback agent returned an invalid action" );
+			return static_cast<Action> ( action );
+		}
+
+		// A copy gets its own state from its first reset()
+		Agent* clone ( void ) const
+		{
+			return new CallbackAgent ( callbacks );
+		}
+
+		void reset ( uint64_t seed )
+		{
+			release();
+			state = callbacks.create ( callbacks.context, seed );
+			live  = true;
+		}
+
+	private:
+
+		void release ( void )
+		{
+			if ( live && callbacks.destroy != NULL )
+				callbacks.destroy ( state );
+			live = false;
+		}
+
+		wumpus_agent_callbacks	callbacks;
+		void*					state = NULL;
+		bool					live  = false;
+	};
+
+	// Agents handed out by wumpus_agent_builtin and wumpus_agent_register.
+	// Entries are never removed, so an id stays valid for the life of the
+	// library.
+	struct AgentEntry
+	{
+		string					name;		// Empty for registered agents
+		wumpus_agent_callbacks	callbacks;
+	};
+
+	mutex				agentsLock;
+	deque<AgentEntry>	agents;
+
+	// Returns a heap-allocated agent for the id, or NULL
+	Agent* makeAgent ( int id )
+	{
+		AgentEntry entry;
+		{
+			lock_guard<mutex> guard ( agentsLock );
+			if ( id < 0 || static_cast<size_t> ( id ) >= agents.size() )
+				return NULL;
+			entry = agents[id];
+		}
+
+		if ( entry.name.empty() )
+			return new CallbackAgent ( entry.callbacks );
+		return AgentRegistry::make ( entry.name );
+	}
+
+	// Games are handed out in blocks, so no two threads write results on
+	// the same cache line
+	const size_t BLOCK = 64;
+
+	// Plays the blocks of games 'next' hands out, one Player per call.
+	// Returns the number of games played.
+	size_t playBatch
+	(
+		const wumpus_suite&	suite,
+		int					agent,
+		const size_t*		worlds,
+		const uint64_t*		seeds,
+		size_t				count,
+		atomic<size_t>&		next,
+		wumpus_result*		results
+	)
+	{
+		unique_ptr<Player>	player;
+		size_t				played = 0;
+
+		for ( size_t first; ( first = next.fetch_add ( BLOCK ) ) < count; )
+		{
+			size_t last = min ( first + BLOCK, count );
+			for ( size_t i = first; i < last; ++i )
+			{
+				size_t	 world = worlds == NULL ? i : worlds[i];
+				uint64_t seed  = seeds  == NULL ? 0 : seeds[i];
+
+				if ( world >= suite.worlds.size() || !suite.worlds[world].isPlayable() )
+				{
+					results[i].status = WUMPUS_BAD_ARGUMENT;
+					continue;
+				}
+
+				try
+				{
+					if ( !player )
+					{
+						Agent* made = makeAgent ( agent );
+						if ( made == NULL )
+						{
+							results[i].status = WUMPUS_BAD_ARGUMENT;
+							continue;
+						}
+						player.reset ( new Player ( made ) );
+					}
+
+					results[i].score  = player->play ( suite.worlds[world], seed );
+					results[i].status = WUMPUS_OK;
+					++played;
+				}
+				catch (...)
+				{
+					// The agent may be left mid-game; the next play() resets it
+					results[i].status = WUMPUS_AGENT_FAILED;
+				}
+			}
+		}
+		return played;
+	}
+}
+
+// ===============================================================
+// =						Suites
+// ===============================================================
+
+int wumpus_api_version ( void )
+{
+	return WUMPUS_API_VERSION;
+}
+
+wumpus_suite* wumpus_suite_create ( void )
+{
+	try
+	{
+		return new wumpus_suite;
+	}
+	catch (...)
+	{
+		return NULL;
+	}
+}
+
+void wumpus_suite_destroy ( wumpus_suite* suite )
+{
+	delete suite;
+}
+
+size_t wumpus_suite_size ( const wumpus_suite* suite )
+{
+	return suite == NULL ? 0 : suite->worlds.size();
+}
+
+int wumpus_suite_add_text ( wumpus_suite* suite, const char* data, size_t length )
+{
+	if ( suite == NULL || data == NULL )
+		return -1;
+
+	try
+	{
+		istringstream		in ( string ( data, length ) );
+		WorldDescription	world;
+		if ( !world.read ( in ) )
+			return -1;
+
+		suite->worlds.push_back ( move ( world ) );
+		return static_cast<int> ( suite->worlds.size() - 1 );
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+int wumpus_suite_add_packed ( wumpus_suite* suite, const void* data, size_t length )
+{
+	if ( suite == NULL || data == NULL )
+		return -1;
+
+	try
+	{
+		istringstream			 in ( string ( static_cast<const char*> ( data ), length ) );
+		vector<WorldDescription> worlds;
+		if ( !WorldDescription::readPacked ( in, worlds ) )
+			return -1;
+
+		suite->worlds.insert ( suite->worlds.end(), worlds.begin(), worlds.end() );
+		return static_cast<int> ( worlds.size() );
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+// ===============================================================
+// =						Agents
+// ===============================================================
+
+int wumpus_agent_builtin ( const char* name )
+{
+	if ( name == NULL )
+		return -1;
+
+	try
+	{
+		unique_ptr<Agent> probe ( AgentRegistry::make ( name ) );
+		if ( !probe )
+			return -1;
+
+		lock_guard<mutex> guard ( agentsLock );
+		for ( size_t id = 0; id < agents.size(); ++id )
+			if ( agents[id].name == name )
+				return static_cast<int> ( id );
+
+		agents.push_back ( AgentEntry { name, wumpus_agent_callbacks() } );
+		return static_cast<int> ( agents.size() - 1 );
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+int wumpus_agent_register ( const wumpus_agent_callbacks* callbacks )
+{
+	if ( callbacks == NULL || callbacks->create == NULL || callbacks->act == NULL )
+		return -1;
+
+	try
+	{
+		lock_guard<mutex> guard ( agentsLock );
+		agents.push_back ( AgentEntry { string(), *callbacks } );
+		return static_cast<int> ( agents.size() - 1 );
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+// ===============================================================
+// =						Batches
+// ===============================================================
+
+size_t wumpus_run_batch
+(
+	const wumpus_suite*	suite,
+	int					agent,
+	const size_t*		worlds,
+	const uint64_t*		seeds,
+	size_t				count,
+	int					threads,
+	wumpus_result*		results
+)
+{
+	if ( results == NULL )
+		return 0;
+
+	for ( size_t i = 0; i < count; ++i )
+		results[i] = wumpus_result { 0, suite == NULL ? WUMPUS_BAD_ARGUMENT : WUMPUS_AGENT_FAILED };
+	if ( suite == NULL )
+		return 0;
+
+	// One count per thread, each on its own cache line
+	struct alignas ( Affinity::CACHE_LINE ) Count
+	{
+		size_t played = 0;
+	};
+
+	try
+	{
+		size_t			total = threads > 1 ? min<size_t> ( threads, ( count + BLOCK - 1 ) / BLOCK ) : 1;
+		vector<Count>	counts ( max<size_t> ( total, 1 ) );
+		atomic<size_t>	next ( 0 );
+		vector<thread>	workers;
+
+		// The calling thread plays too, so a thread that fails to start
+		// only costs parallelism. No thread is pinned: the library cannot
+		// know what else the embedding process runs.
+		try
+		{
+			for ( size_t t = 1; t < total; ++t )
+				workers.emplace_back ( [&, t]
+				{
+					counts[t].played = playBatch ( *suite, agent, worlds, seeds, count, next, results );
+				} );
+		}
+		catch (...)
+		{
+		}
+
+		counts[0].played = playBatch ( *suite, agent, worlds, seeds, count, next, results );
+		for ( thread& worker : workers )
+			worker.join();
+
+		size_t played = 0;
+		for ( const Count& c : counts )
+			played += c.played;
+		return played;
+	}
+	catch (...)
+	{
+		for ( size_t i = 0; i < count; ++i )
+			results[i] = wumpus_result { 0, WUMPUS_AGENT_FAILED };
+		return 0;
+	}
+}
@@ -0,0 +1,202 @@
+// ======================================================================
+// FILE:        Compare.cpp
+//
+// DESCRIPTION: This file contains the compare mode, which plays two
+//              agents on the same games until their difference is
+//              resolved.
+// ======================================================================
+
+#include "Compare.hpp"
+#include "AgentRegistry.hpp"
+#include "Player.hpp"
+#include "Suite.hpp"
+#include "Statistics.hpp"
+#include "Random.hpp"
+#include "Hash.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+struct CompareOptions
+{
+	uint64_t	seed       = 0;
+	double		confidence = 0.95;
+	double		margin     = 0;
+	size_t		minGames   = 32;
+	int			rounds     = 1;
+};
+
+// The z with a two-sided normal tail of 'error', by bisection
+static double criticalValue ( double error )
+{
+	double low = 0, high = 40;
+	for ( int step = 0; step < 100; ++step )
+	{
+		double middle = ( low + high ) / 2;
+		if ( erfc ( middle / sqrt ( 2.0 ) ) > error )
+			low = middle;
+		else
+			high = middle;
+	}
+	return high;
+}
+
+// Half-width of the interval around the mean difference at a look
+static double halfWidth ( const RunningStats& differences, double error )
+{
+	if ( differences.count < 2 )
+		return INFINITY;
+	double sampleVariance = differences.m2 / ( differences.count - 1 );
+	return criticalValue ( error ) * sqrt ( sampleVariance / differences.count );
+}
+
+int runCompare ( int argc, char* argv[] )
+{
+	if ( argc < 3 )
+	{
+		cout << "[ERROR] Usage: compare AgentA AgentB Suite [Options]" << endl;
+		return 0;
+	}
+
+	string	nameA = argv[0];
+	string	nameB = argv[1];
+	string	path  = argv[2];
+
+	CompareOptions options;
+	for ( int index = 3; index < argc; ++index )
+	{
+		string token = argv[index];
+
+		if ( token == "--seed" && index + 1 < argc )
+			options.seed = strtoull ( argv[++index], NULL, 10 );
+		else if ( token == "--confidence" && index + 1 < argc )
+			options.confidence = atof ( argv[++index] );
+		else if ( token == "--margin" && index + 1 < argc )
+			options.margin = max ( 0.0, atof ( argv[++index] ) );
+		else if ( token == "--min-games" && index + 1 < argc )
+			options.minGames = max ( 2ul, strtoul ( argv[++index], NULL, 10 ) );
+		else if ( token == "--rounds" && index + 1 < argc )
+			options.rounds = max ( 1, atoi ( argv[++index] ) );
+		else
+		{
+			cout << "[ERROR] Unknown compare option " << token << "." << endl;
+			return 0;
+		}
+	}
+
+	if ( options.confidence <= 0 || options.confidence >= 1 )
+	{
+		cout << "[ERROR] --confidence expects a value between 0 and 1." << endl;
+		return 0;
+	}
+
+	Agent* agentA = AgentRegistry::make ( nameA );
+	Agent* agentB = AgentRegistry::make ( nameB );
+	if ( agentA == NULL || agentB == NULL )
+	{
+		cout << "[ERROR] Unknown agent " << ( agentA == NULL ? nameA : nameB ) << "." << endl;
+		delete agentA;
+		delete agentB;
+		return 0;
+	}
+	Player playerA ( agentA );
+	Player playerB ( agentB );
+
+	Suite suite;
+	if ( !loadSuite ( path, suite ) || suite.worlds.empty() )
+	{
+		cout << "[ERROR] Failed to load suite " << path << "." << endl;
+		return 0;
+	}
+
+	// Every round plays the suite in its own shuffled order
+	vector<pair<int, size_t>> games;
+	SplitMix64 random ( options.seed );
+	for ( int round = 0; round < options.rounds; ++round )
+	{
+		size_t first = games.size();
+		for ( size_t world = 0; world < suite.worlds.size(); ++world )
+			games.emplace_back ( round, world );
+		for ( size_t i = games.size() - 1; i > first; --i )
+			swap ( games[i], games[first + random.next() % ( i - first + 1 )] );
+	}
+
+	RunningStats	scoresA, scoresB, differences;
+	size_t			failures = 0;
+	size_t			nextLook = options.minGames;
+	size_t			lastLook = 0;		// Games played at the last look
+	double			error    = ( 1 - options.confidence ) / 2;
+	double			width    = INFINITY;
+	bool			resolved = false;
+
+	for ( const auto& game : games )
+	{
+		const string&	name = suite.names[game.second];
+		uint64_t		seed = Hash::fnv1a ( name, options.seed + game.first );
+		int				scoreA, scoreB;
+		try
+		{
+			scoreA = playerA.play ( suite.worlds[game.second], seed );
+			scoreB = playerB.play ( suite.worlds[game.second], seed );
+		}
+		catch (...)
+		{
+			cout << "[WARNING] " << name << " failed; leaving it out." << endl;
+			++failures;
+			continue;
+		}
+
+		scoresA.add ( scoreA );
+		scoresB.add ( scoreB );
+		differences.add ( scoreA - scoreB );
+
+		if ( differences.count < nextLook )
+			continue;
+
+		width    = halfWidth ( differences, error );
+		lastLook = differences.count;
+		cout << "After " << differences.count << " games: " << nameA << " - " << nameB << " = "
+			 << differences.mean << " +- " << width << endl;
+
+		if ( differences.mean - width > 0 || differences.mean + width < 0
+				|| ( options.margin > 0 && width <= options.margin ) )
+		{
+			resolved = true;
+			break;
+		}
+		nextLook *= 2;
+		error    /= 2;
+	}
+
+	// A final look when the games ran out after the last look, or
+	// before the first
+	if ( !resolved && differences.count > 0 && differences.count != lastLook )
+		width = halfWidth ( differences, error );
+
+	cout << endl;
+	cout << "Games played: " << differences.count << " of " << games.size();
+	if ( failures > 0 )
+		cout << " (" << failures << " failed)";
+	cout << endl;
+	cout << nameA << " average score: " << scoresA.mean << endl;
+	cout << nameB << " average score: " << scoresB.mean << endl;
+	cout << "Difference: " << differences.mean << " +- " << width
+		 << " (" << options.confidence * 100 << "% confidence)" << endl;
+
+	if ( differences.mean - width > 0 )
+		cout << "Result: " << nameA << " scores higher." << endl;
+	else if ( differences.mean + width < 0 )
+		cout << "Result: " << nameB << " scores higher." << endl;
+	else if ( options.margin > 0 && width <= options.margin )
+		cout << "Result: the agents are within " << options.margin << " points of each other." << endl;
+	else
+		cout << "Result: not resolved; the games ran out." << endl;
+	return 0;
+}
@@ -0,0 +1,52 @@
+// ======================================================================
+// FILE:        Compare.hpp
+//
+// DESCRIPTION: This file contains the compare mode, which decides
+//              whether one agent scores higher than another. Both agents
+//              play the same worlds with the same seeds, so the noise
+//              the worlds share cancels out of the score differences,
+//              and play stops as soon as the mean difference is resolved
+//              instead of after the whole suite.
+//
+// NOTES:       - Syntax:
+//
+//                  Wumpus_World compare AgentA AgentB Suite [Options]
+//
+//                  Agents are AgentRegistry names; Suite is a folder or a
+//                  packed suite file (see Suite.hpp).
+//
+//                  Options:
+//                      --seed S        Seed for the game order and the
+//                                      games. Default 0.
+//                      --confidence C  Confidence of the result. Default
+//                                      0.95.
+//                      --margin D      Also stop once the difference is
+//                                      known to within +-D points.
+//                                      Default 0 (never).
+//                      --min-games N   Games before the first look.
+//                                      Default 32.
+//                      --rounds R      Play the suite up to R times, with
+//                                      seeds S, S+1, ... Default 1.
+//
+//              - Game g of round r plays world w with the seed -f --seed
+//                S+r gives w, first with AgentA and then with AgentB. The
+//                worlds are shuffled by S, so stopping early samples the
+//                suite evenly rather than by file name.
+//
+//              - The paired differences are accumulated as RunningStats.
+//                The result is checked at looks after N, 2N, 4N, ...
+//                games, the k-th look with a two-sided normal interval
+//                at error (1 - C) / 2^(k+1). The errors add up to at
+//                most 1 - C, so looking repeatedly does not inflate it.
+//
+//              - A world that throws for either agent is left out of the
+//                comparison and counted as a failure.
+// ======================================================================
+
+#ifndef COMPARE_LOCK
+#define COMPARE_LOCK
+
+// Runs the compare subcommand on the arguments that follow it
+int runCompare ( int argc, char* argv[] );
+
+#endif /* COMPARE_LOCK */
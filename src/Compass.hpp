@@ -0,0 +1,75 @@
+// ======================================================================
+// FILE:        Compass.hpp
+//
+// DESCRIPTION: This file contains the direction tables shared by the
+//              engines and MyAI: the step each direction takes, what
+//              each direction becomes after a turn, and the mapping
+//              between the two encodings of a direction in the program.
+//
+// NOTES:       - The engines (World, FixedWorld) encode a direction as
+//                0 - right, 1 - down, 2 - left, 3 - up, so a right turn
+//                adds one. MyAI::Direction lists Up, Down, Left, Right,
+//                so opposite directions differ in the lowest bit.
+//                Everything here is in the engine encoding except the
+//                AGENT_ tables, which are indexed by MyAI::Direction.
+//
+//              - Columns grow to the right and rows grow upwards, as
+//                in the Wumpus World File.
+// ======================================================================
+
+#ifndef COMPASS_LOCK
+#define COMPASS_LOCK
+
+namespace Compass
+{
+	const int RIGHT = 0;
+	const int DOWN  = 1;
+	const int LEFT  = 2;
+	const int UP    = 3;
+
+	// Step taken by moving one cell forward
+	constexpr int DX[4] = { 1, 0, -1, 0 };
+	constexpr int DY[4] = { 0, -1, 0, 1 };
+
+	// Direction faced after turning
+	constexpr int LEFT_OF [4] = { UP, RIGHT, DOWN, LEFT };
+	constexpr int RIGHT_OF[4] = { DOWN, LEFT, UP, RIGHT };
+
+	// MyAI::Direction (Up, Down, Left, Right) to the engine encoding and
+	// back. The mapping swaps right and up, so it is its own inverse.
+	constexpr int FROM_AGENT[4] = { UP, DOWN, LEFT, RIGHT };
+	constexpr int TO_AGENT  [4] = { 3, 1, 2, 0 };
+
+	// The same tables, indexed by MyAI::Direction and giving one
+	constexpr int AGENT_DX      [4] = { 0, 0, -1, 1 };
+	constexpr int AGENT_DY      [4] = { 1, -1, 0, 0 };
+	constexpr int AGENT_LEFT_OF [4] = { 2, 3, 1, 0 };
+	constexpr int AGENT_RIGHT_OF[4] = { 3, 2, 0, 1 };
+
+	// Checks every table against DX and DY: a right turn rotates the
+	// step clockwise, a left turn undoes it, and the agent tables agree
+	// with the engine tables through the mapping
+	constexpr bool isConsistent ( void )
+	{
+		for ( int d = 0; d < 4; ++d )
+		{
+			if ( DX[RIGHT_OF[d]] != DY[d] || DY[RIGHT_OF[d]] != -DX[d] )
+				return false;
+			if ( LEFT_OF[RIGHT_OF[d]] != d )
+				return false;
+			if ( TO_AGENT[FROM_AGENT[d]] != d )
+				return false;
+
+			int e = FROM_AGENT[d];
+			if ( AGENT_DX[d] != DX[e] || AGENT_DY[d] != DY[e] )
+				return false;
+			if ( FROM_AGENT[AGENT_LEFT_OF[d]] != LEFT_OF[e] || FROM_AGENT[AGENT_RIGHT_OF[d]] != RIGHT_OF[e] )
+				return false;
+		}
+		return true;
+	}
+
+	static_assert ( isConsistent(), "Compass tables disagree" );
+}
+
+#endif /* COMPASS_LOCK */
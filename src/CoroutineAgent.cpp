@@ -0,0 +1,81 @@
+// ======================================================================
+// FILE:        CoroutineAgent.cpp
+//
+// DESCRIPTION: This file contains FramePool, the allocator for the
+//              frames of CoroutineAgent plans.
+// ======================================================================
+
+#include "CoroutineAgent.hpp"
+
+#ifdef WW_COROUTINES
+
+#include <new>
+
+namespace
+{
+	struct FreeFrame
+	{
+		FreeFrame* next;
+	};
+
+	// Free lists by size class, owned by one thread. Frames still on the
+	// lists go back to the heap when the thread exits.
+	struct Pool
+	{
+		FreeFrame* free[FramePool::CLASSES] = {};
+
+		~Pool()
+		{
+			for ( FreeFrame*& head : free )
+				while ( head )
+				{
+					FreeFrame* frame = head;
+					head = head->next;
+					::operator delete ( frame );
+				}
+		}
+	};
+
+	thread_local Pool pool;
+
+	// Size class of a frame, or CLASSES if it is too large for the pool
+	size_t sizeClass ( size_t size )
+	{
+		size_t index = ( size + FramePool::GRANULE - 1 ) / FramePool::GRANULE;
+		return index == 0 ? 0 : index - 1;
+	}
+}
+
+void* FramePool::allocate ( size_t size )
+{
+	size_t index = sizeClass ( size );
+	if ( index >= CLASSES )
+		return ::operator new ( size );
+
+	FreeFrame*& head = pool.free[index];
+	if ( head )
+	{
+		FreeFrame* frame = head;
+		head = head->next;
+		return frame;
+	}
+	return ::operator new ( ( index + 1 ) * GRANULE );
+}
+
+void FramePool::release ( void* frame, size_t size )
+{
+	size_t index = sizeClass ( size );
+	if ( index >= CLASSES )
+	{
+		::operator delete ( frame );
+		return;
+	}
+
+	// A frame freed on another thread joins that thread's lists; all
+	// blocks of a class have the same size, so that is harmless
+	FreeFrame* node = static_cast<FreeFrame*> ( frame );
+	node->next = pool.free[index];
+	pool.free[index] = node;
+}
+
+#endif /* WW_COROUTINES */
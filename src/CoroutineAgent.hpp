@@ -0,0 +1,213 @@
+// ======================================================================
+// FILE:        CoroutineAgent.hpp
+//
+// DESCRIPTION: This file contains CoroutineAgent, an adapter that lets
+//              an agent be written as a C++20 coroutine. The agent's
+//              plan co_awaits the percepts and co_yields its actions;
+//              getAction() resumes the plan where it left off, so a
+//              multi-step plan is straight-line code instead of a
+//              queue of actions and a set of state flags.
+//
+// NOTES:       - Only available when the compiler implements coroutines
+//                (-std=c++20 or later); otherwise this header declares
+//                nothing and WW_COROUTINES is left undefined.
+//
+//              - A plan sees the percepts of the turn it was resumed
+//                for. After every co_yield it should co_await percepts()
+//                again before deciding. A plan that returns climbs on
+//                every later turn.
+//
+//                  class ScaredAI : public CoroutineAgent
+//                  {
+//                      Plan makePlan ( void )
+//                      {
+//                          Percepts p = co_await percepts();
+//                          if ( p.glitter )
+//                              co_yield GRAB;
+//                          co_yield CLIMB;
+//                      }
+//                      Agent* clone ( void ) const { return new ScaredAI; }
+//                  };
+//
+//                ScoutAI.hpp is a complete agent written this way.
+//
+//              - Frames come from FramePool, which keeps freed frames on
+//                per-thread free lists by size, so starting a plan per
+//                game does not go to the heap once the pool is warm.
+//
+//              - A coroutine cannot be copied, so clone() is only
+//                meaningful before the first getAction(); a World
+//                running a CoroutineAgent cannot be copied mid-game.
+// ======================================================================
+
+#ifndef COROUTINEAGENT_LOCK
+#define COROUTINEAGENT_LOCK
+
+#if defined ( __cpp_impl_coroutine )
+
+#define WW_COROUTINES
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+#include "Agent.hpp"
+
+namespace FramePool
+{
+	// Frames are rounded up to a multiple of GRANULE bytes; frames larger
+	// than GRANULE * CLASSES bypass the pool
+	const size_t GRANULE = 64;
+	const size_t CLASSES = 32;
+
+	void*	allocate	( size_t size );
+	void	release		( void* frame, size_t size );
+}
+
+// What the agent senses at the start of a turn
+struct Percepts
+{
+	bool	stench  = false;
+	bool	breeze  = false;
+	bool	glitter = false;
+	bool	bump    = false;
+	bool	scream  = false;
+};
+
+class CoroutineAgent : public Agent
+{
+public:
+
+	// co_await percepts() in a plan gives the current turn's percepts
+	struct PerceptRequest {};
+	static PerceptRequest percepts ( void ) { return {}; }
+
+	class Plan
+	{
+	public:
+
+		struct promise_type
+		{
+			Action				action = CLIMB;		// Last action yielded
+			Percepts			current;
+			std::exception_ptr	error;
+
+			Plan get_return_object ( void ) { return Plan ( Handle::from_promise ( *this ) ); }
+
+			// The plan starts on the first getAction(), when there
+			// are percepts to give it
+			std::suspend_always	initial_suspend	( void ) noexcept { return {}; }
+			std::suspend_always	final_suspend	( void ) noexcept { return {}; }
+
+			std::suspend_always yield_value ( Action next ) noexcept
+			{
+				action = next;
+				return {};
+			}
+
+			void return_void ( void ) {}
+			void unhandled_exception ( void ) { error = std::current_exception(); }
+
+			struct PerceptAwaiter
+			{
+				const Percepts& percepts;
+
+				bool		await_ready		( void ) const noexcept { return true; }
+				void		await_suspend	( std::coroutine_handle<> ) const noexcept {}
+				Percepts	await_resume	( void ) const noexcept { return percepts; }
+			};
+
+			PerceptAwaiter await_transform ( PerceptRequest ) const noexcept { return { current }; }
+
+			static void* operator new ( size_t size ) { return FramePool::allocate ( size ); }
+			static void operator delete ( void* frame, size_t size ) { FramePool::release ( frame, size ); }
+		};
+
+		typedef std::coroutine_handle<promise_type> Handle;
+
+		Plan ( void ) : handle ( nullptr ) {}
+		Plan ( Plan&& other ) noexcept : handle ( std::exchange ( other.handle, nullptr ) ) {}
+
+		Plan& operator= ( Plan&& other ) noexcept
+		{
+			if ( this != &other )
+			{
+				if ( handle )
+					handle.destroy();
+				handle = std::exchange ( other.handle, nullptr );
+			}
+			return *this;
+		}
+
+		Plan ( const Plan& ) = delete;
+		Plan& operator= ( const Plan& ) = delete;
+
+		~Plan() { if ( handle ) handle.destroy(); }
+
+		explicit operator bool ( void ) const { return handle != nullptr; }
+
+		// Runs the plan up to its next action. Returns false once the
+		// plan has returned; rethrows anything the plan threw.
+		bool resume ( const Percepts& percepts )
+		{
+			if ( handle.done() )
+				return false;
+
+			handle.promise().current = percepts;
+			handle.resume();
+
+			if ( handle.promise().error )
+				std::rethrow_exception ( handle.promise().error );
+			return !handle.done();
+		}
+
+		Action action ( void ) const { return handle.promise().action; }
+
+	private:
+		explicit Plan ( Handle _handle ) : handle ( _handle ) {}
+
+		Handle handle;
+	};
+
+	Action getAction
+	(
+		bool stench,
+		bool breeze,
+		bool glitter,
+		bool bump,
+		bool scream
+	)
+	{
+		if ( !plan )
+			plan = makePlan();
+
+		Percepts percepts;
+		percepts.stench  = stench;
+		percepts.breeze  = breeze;
+		percepts.glitter = glitter;
+		percepts.bump    = bump;
+		percepts.scream  = scream;
+
+		return plan.resume ( percepts ) ? plan.action() : CLIMB;
+	}
+
+	// Drops the plan in progress; the next getAction() starts a new one.
+	// The old frame goes back to FramePool for the new plan to reuse.
+	void reset ( uint64_t /*seed*/ )
+	{
+		plan = Plan();
+	}
+
+protected:
+
+	// Starts the plan for a new game; called on the first getAction()
+	virtual Plan makePlan ( void ) = 0;
+
+private:
+
+	Plan plan;
+};
+
+#endif /* __cpp_impl_coroutine */
+
+#endif /* COROUTINEAGENT_LOCK */
@@ -0,0 +1,326 @@
+// ======================================================================
+// FILE:        Evaluator.cpp
+//
+// DESCRIPTION: This file contains the evaluator, which plays every world
+//              of a folder (-f mode).
+// ======================================================================
+
+#include "Evaluator.hpp"
+#include "Hash.hpp"
+#include "PrefixCache.hpp"
+#include "ResultCache.hpp"
+#include "Profiler.hpp"
+#include "Progress.hpp"
+#include "FixedWorld.hpp"
+#include "Suite.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// ===============================================================
+// =					Budget Report
+// ===============================================================
+
+void BudgetReport::add ( const World& world, const string& name )
+{
+	const World::Timing& timing = world.getTiming();
+
+	++games;
+	if ( world.getOutcome() == World::FORFEITED )
+		++forfeits;
+	moves           += timing.moves;
+	overBudgetMoves += timing.overBudgetMoves;
+	if ( timing.overBudgetGame )
+		overBudgetGames.push_back ( name );
+	if ( timing.slowestMove > slowestMove )
+	{
+		slowestMove  = timing.slowestMove;
+		slowestWorld = name;
+	}
+}
+
+void BudgetReport::print ( ostream& out ) const
+{
+	// Over-budget games are named up to this many
+	const size_t MAX_LISTED = 10;
+
+	out << "Over-budget moves: " << overBudgetMoves << " of " << moves << endl;
+	out << "Slowest move: " << chrono::duration_cast<chrono::microseconds> ( slowestMove ).count()
+		<< " us (" << slowestWorld << ")" << endl;
+	out << "Over-budget games: " << overBudgetGames.size() << " of " << games << endl;
+	for ( size_t i = 0; i < overBudgetGames.size() && i < MAX_LISTED; ++i )
+		out << "\t" << overBudgetGames[i] << endl;
+	if ( overBudgetGames.size() > MAX_LISTED )
+		out << "\t... and " << overBudgetGames.size() - MAX_LISTED << " more" << endl;
+	out << "Forfeited games: " << forfeits << " of " << games << endl;
+}
+
+// ===============================================================
+// =						Evaluator
+// ===============================================================
+
+Evaluator::Evaluator ( const EvaluationOptions& _options )
+	: options ( _options ), simulated ( 0 )
+{
+}
+
+bool Evaluator::load ( const string& folder )
+{
+	struct stat info;
+	if ( stat ( folder.c_str(), &info ) != 0 )
+		return false;
+	if ( !S_ISDIR ( info.st_mode ) )
+	{
+		if ( !loadPacked ( folder ) )
+			return false;
+		if ( options.dedupe )
+			group();
+		return true;
+	}
+
+	DIR *dir;
+	if ( ( dir = opendir (folder.c_str()) ) == NULL )
+		return false;
+
+	struct dirent *ent;
+
+	while ( ( ent = readdir (dir) ) != NULL )
+	{
+		if ( ent->d_name[0] == '.' )
+			continue;
+
+		string name = ent->d_name;
+		if ( name.size() > 5 && name.compare ( name.size() - 5, 5, ".pack" ) == 0 )
+		{
+			// A pack that fails to read fails the run like a bad world
+			if ( !loadPacked ( folder + "/" + name ) )
+			{
+				Entry entry;
+				entry.name   = name;
+				entry.valid  = false;
+				entry.weight = 1;
+				entries.push_back ( move ( entry ) );
+			}
+			continue;
+		}
+
+		// Partition by a stable hash of the name alone, so every
+		// machine agrees on the shards whatever the folder path
+		if ( options.shardCount > 0 && Hash::fnv1a ( ent->d_name ) % options.shardCount != (uint64_t) options.shardIndex )
+			continue;
+
+		Entry entry;
+		ifstream file ( folder + "/" + ent->d_name );
+		entry.name   = ent->d_name;
+		entry.valid  = entry.description.read ( file );
+		entry.weight = 1;
+		entries.push_back ( move ( entry ) );
+	}
+
+	closedir (dir);
+
+	if ( options.dedupe )
+		group();
+	return true;
+}
+
+bool Evaluator::loadPacked ( const string& path )
+{
+	Suite suite;
+	if ( !loadSuite ( path, suite ) )
+		return false;
+
+	for ( size_t i = 0; i < suite.worlds.size(); ++i )
+	{
+		if ( options.shardCount > 0 && Hash::fnv1a ( suite.names[i] ) % options.shardCount != (uint64_t) options.shardIndex )
+			continue;
+
+		Entry entry;
+		entry.name        = suite.names[i];
+		entry.description = move ( suite.worlds[i] );
+		entry.valid       = true;
+		entry.weight      = 1;
+		entries.push_back ( move ( entry ) );
+	}
+	return true;
+}
+
+void Evaluator::group ( void )
+{
+	unique_ptr<Agent> agent ( World::makeAgent ( options.randomAI, options.manualAI ) );
+	if ( !agent->isDeterministic() )
+	{
+		cout << "[WARNING] The agent is not deterministic; every world will be played." << endl;
+		return;
+	}
+	bool symmetric = agent->isSymmetryAware();
+
+	// Key to the entry that represents the group
+	unordered_map<uint64_t, size_t> representatives;
+
+	for ( size_t index = 0; index < entries.size(); ++index )
+	{
+		Entry& entry = entries[index];
+		if ( !entry.valid )
+			continue;
+
+		uint64_t key = symmetric ? entry.description.canonicalKey() : entry.description.key();
+		auto found = representatives.emplace ( key, index );
+		if ( !found.second )
+		{
+			++entries[found.first->second].weight;
+			entry.weight = 0;
+		}
+	}
+}
+
+void Evaluator::run ( void )
+{
+	PrefixCache prefixCache;
+	bool timed = options.budget.perMove.count() > 0 || options.budget.perGame.count() > 0;
+
+	// Plain games go to the specialised engines; anything that needs the
+	// display, the cache or the clock goes through World
+	bool plain = !options.debug && !options.manualAI && !options.cache && !timed;
+
+	// One agent for the specialised engines and one World serve every
+	// game; both are reset between games rather than rebuilt
+	unique_ptr<Agent>	agent ( World::makeAgent ( options.randomAI, options.manualAI ) );
+	unique_ptr<World>	world;
+
+	// Scores are only reused for games the cache can stand in for
+	ResultCache	results;
+	const char*	buildId       = agent->buildId();
+	bool		deterministic = agent->isDeterministic();
+	bool		cached        = false;
+	bool		recording     = !options.analytics.empty();
+	if ( !options.resultCache.empty() )
+	{
+		if ( options.debug || options.manualAI || timed || recording || buildId == NULL )
+			cout << "[WARNING] The result cache is not used with -d, -m, a time budget, --analytics or this agent." << endl;
+		else if ( !results.open ( options.resultCache ) )
+			cout << "[WARNING] Failed to open result cache " << options.resultCache << "; every world will be played." << endl;
+		else
+			cached = true;
+	}
+
+	unique_ptr<ProgressReporter> progress;
+	if ( options.progress.count() > 0 )
+		progress.reset ( new ProgressReporter ( entries.size(), options.progress, options.progressFile,
+			[this] ( size_t index ) { return entries[index].name; } ) );
+
+	for ( size_t index = 0; index < entries.size(); ++index )
+	{
+		const Entry& entry = entries[index];
+		if ( entry.weight == 0 )
+			continue;
+
+		if ( options.verbose )
+			cout << "Running world: " << entry.name << endl;
+
+		// Seeded by name, so a world plays the same whatever the
+		// order, the shard or the engine
+		uint64_t	seed = Hash::fnv1a ( entry.name, options.seed );
+		int			score;
+		try
+		{
+			if ( !entry.valid )
+				throw exception();
+
+			uint64_t key = 0;
+			if ( cached )
+			{
+				key = ResultCache::makeKey ( entry.description.key(), buildId, deterministic ? 0 : seed );
+				if ( results.find ( key, score ) )
+				{
+					for ( size_t i = 0; i < entry.weight; ++i )
+						stats.add ( score );
+					if ( progress )
+						progress->add ( entry.weight, score, chrono::nanoseconds ( 0 ), index );
+					continue;
+				}
+			}
+
+			chrono::steady_clock::time_point started;
+			if ( progress )
+				started = chrono::steady_clock::now();
+
+			if ( plain )
+				agent->reset ( World::agentSeed ( seed ) );
+
+			spatial.weight = entry.weight;
+			if ( !plain || !playFixed ( entry.description, *agent, score, recording ? &spatial : NULL ) )
+			{
+				if ( world )
+					world->reset ( entry.description, seed );
+				else
+				{
+					world.reset ( new World ( entry.description, options.debug, options.randomAI, options.manualAI, seed ) );
+					world->setRenderer ( options.renderer );
+					world->setTimeBudget ( options.budget );
+					if ( options.cache )
+						world->setPrefixCache ( &prefixCache );
+					if ( recording )
+						world->setAnalytics ( &spatial );
+				}
+				score = world->run();
+				if ( timed )
+					budgetReport.add ( *world, entry.name );
+			}
+
+			if ( progress )
+				progress->add ( entry.weight, score, chrono::steady_clock::now() - started, index );
+
+			if ( cached && !results.insert ( key, score ) )
+			{
+				cout << "[WARNING] Failed to grow result cache " << options.resultCache << "; no more scores will be added." << endl;
+				cached = false;
+			}
+		}
+		catch (...)
+		{
+            std::cout << "error caught, resetting scores" << std::endl;
+			stats.reset();
+			spatial.reset();
+			break;
+		}
+
+		++simulated;
+		for ( size_t i = 0; i < entry.weight; ++i )
+			stats.add ( score );
+	}
+
+	// The last report comes before the summary
+	progress.reset();
+
+	if ( recording )
+	{
+		ofstream file ( options.analytics );
+		spatial.write ( file );
+		if ( !file )
+			cout << "[WARNING] Failed to write analytics file " << options.analytics << "." << endl;
+	}
+
+#ifdef WW_PROFILE
+	Profiler::printSummary ( cout );
+#endif
+
+	if ( options.cache && options.verbose )
+		cout << "Prefix cache: " << prefixCache.size() << " entries, "
+			 << prefixCache.getHits() << " hits in "
+			 << prefixCache.getLookups() << " lookups" << endl;
+
+	if ( cached && options.verbose )
+		cout << "Result cache: " << results.size() << " entries, "
+			 << results.getHits() << " hits in "
+			 << results.getLookups() << " lookups" << endl;
+
+	if ( options.dedupe && options.verbose )
+		cout << "Simulated " << simulated << " of " << entries.size() << " worlds" << endl;
+}
@@ -0,0 +1,135 @@
+// ======================================================================
+// FILE:        Evaluator.hpp
+//
+// DESCRIPTION: This file contains the evaluator, which plays every world
+//              of a folder (-f mode) and accumulates the statistics of
+//              the agent's scores.
+//
+// NOTES:       - A run first lists the folder, keeping only this shard's
+//                worlds, and parses every world. With dedupe on, worlds
+//                with the same board are grouped and only the first of
+//                each group is played; its score counts once per member,
+//                so the statistics are exactly those of a full run.
+//
+//              - A packed suite file (see Generator.hpp), given instead of
+//                a folder or found in one as a .pack file, is expanded
+//                into its worlds, named <pack>/world_<k> as Suite names
+//                them.
+//
+//              - Games that need neither the debug display, the prefix
+//                cache nor a time budget are played by the FixedWorld
+//                engine for their board size when there is one.
+//
+//              - With a result cache (see ResultCache.hpp), a world whose
+//                score is cached is not played, and every score played is
+//                added to the cache. The cache is skipped with the debug
+//                display, the ManualAI or a time budget, whose games it
+//                could not reproduce.
+//
+//              - With a progress interval, a side thread reports the run's
+//                progress as it goes (see Progress.hpp). Unlike -v, this
+//                costs the playing loop a clock read and a few counter
+//                increments per world.
+//
+//              - With an analytics file, every game is recorded into one
+//                SpatialStats (see Analytics.hpp), each deduplicated game
+//                counting once per copy, and the totals are written to
+//                the file at the end. Cached scores carry no moves to
+//                record, so the result cache is skipped.
+//
+//              - Dedupe only groups identical boards, and only for
+//                deterministic agents. Boards that are mirror images
+//                along the diagonal through the start are grouped too
+//                when the agent is symmetry-aware (see Agent.hpp).
+// ======================================================================
+
+#ifndef EVALUATOR_LOCK
+#define EVALUATOR_LOCK
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "World.hpp"
+#include "WorldDescription.hpp"
+#include "Statistics.hpp"
+#include "Analytics.hpp"
+#include "FrameRenderer.hpp"
+
+struct EvaluationOptions
+{
+	bool	debug      = false;
+	bool	verbose    = false;
+	bool	randomAI   = false;
+	bool	manualAI   = false;
+	bool	cache      = false;		// Share a PrefixCache across the folder
+	bool	dedupe     = false;		// Play one world per group of equivalent boards
+	int		shardIndex = 0;
+	int		shardCount = 0;			// 0 when not sharding
+	uint64_t	seed       = 0;		// Combined with each file name to seed its game
+	std::string	resultCache;		// Path of the result cache file; empty for none
+	std::chrono::milliseconds	progress { 0 };	// Progress report interval; 0 for none
+	std::string	progressFile;		// Also write each progress report here (see Progress.hpp)
+	std::string	analytics;			// Write the suite's SpatialStats here; empty for none
+
+	FrameRenderer		renderer;
+	World::TimeBudget	budget;
+};
+
+// Totals of the agent latency measured under a time budget
+struct BudgetReport
+{
+	size_t	games           = 0;
+	size_t	forfeits        = 0;
+	size_t	moves           = 0;
+	size_t	overBudgetMoves = 0;
+	std::vector<std::string>	overBudgetGames;	// Worlds whose game exceeded the per-game budget
+	std::chrono::nanoseconds	slowestMove { 0 };
+	std::string	slowestWorld;
+
+	void	add		( const World& world, const std::string& name );
+	void	print	( std::ostream& out ) const;
+};
+
+class Evaluator
+{
+public:
+
+	Evaluator ( const EvaluationOptions& options );
+
+	// Lists and parses this shard's worlds in the folder or packed suite
+	// file. Returns false if the path cannot be opened; a world that
+	// fails to parse instead makes run() report an error.
+	bool	load	( const std::string& folder );
+
+	// Plays the loaded worlds. On an error, prints it and resets the
+	// statistics, like the original folder loop.
+	void	run		( void );
+
+	const RunningStats&	getStats		( void ) const { return stats; }
+	const SpatialStats&	getAnalytics	( void ) const { return spatial; }
+	const BudgetReport&	getBudgetReport	( void ) const { return budgetReport; }
+	size_t				getSimulated	( void ) const { return simulated; }
+
+private:
+	struct Entry
+	{
+		std::string			name;			// File name within the folder
+		WorldDescription	description;
+		bool				valid;			// False if the file failed to parse
+		size_t				weight;			// Worlds this entry stands for; 0 if another entry stands for it
+	};
+
+	EvaluationOptions	options;
+	std::vector<Entry>	entries;
+	RunningStats		stats;
+	SpatialStats		spatial;
+	BudgetReport		budgetReport;
+	size_t				simulated;
+
+	void	group	( void );
+	bool	loadPacked	( const std::string& path );
+};
+
+#endif /* EVALUATOR_LOCK */
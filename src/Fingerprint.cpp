@@ -0,0 +1,235 @@
+// ======================================================================
+// FILE:        Fingerprint.cpp
+//
+// DESCRIPTION: This file contains the fingerprint mode, which records an
+//              agent's actions on a suite and diffs them against a
+//              baseline.
+// ======================================================================
+
+#include "Fingerprint.hpp"
+#include "AgentRegistry.hpp"
+#include "Player.hpp"
+#include "Suite.hpp"
+#include "Hash.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+static const char ACTION_LETTERS[] = "LRFSGC";
+
+// The actions of one game
+struct Trace
+{
+	int			score = 0;
+	uint64_t	hash  = Hash::FNV_OFFSET;
+	string		actions;
+
+	void clear ( void )
+	{
+		score = 0;
+		hash  = Hash::FNV_OFFSET;
+		actions.clear();
+	}
+};
+
+// Passes every call on to the agent it wraps, and appends each action it
+// returns to a trace. Copies record into the same trace, so the World a
+// Player builds from a clone records too.
+class RecordingAgent : public Agent
+{
+public:
+
+	RecordingAgent ( Agent* _agent, Trace* _trace ) : agent ( _agent ), trace ( _trace ) {}
+
+	Action getAction ( bool stench, bool breeze, bool glitter, bool bump, bool scream )
+	{
+		Action action = agent->getAction ( stench, breeze, glitter, bump, scream );
+		trace->hash = Hash::fnv1a ( trace->hash, static_cast<unsigned char> ( action ) );
+		trace->actions.push_back ( ACTION_LETTERS[action] );
+		return action;
+	}
+
+	Agent* clone ( void ) const
+	{
+		return new RecordingAgent ( agent->clone(), trace );
+	}
+
+	bool isDeterministic ( void ) const { return agent->isDeterministic(); }
+	bool isSymmetryAware ( void ) const { return agent->isSymmetryAware(); }
+	void reset ( uint64_t seed ) { agent->reset ( seed ); }
+
+private:
+	unique_ptr<Agent>	agent;
+	Trace*				trace;
+};
+
+static const char* actionName ( char letter )
+{
+	switch ( letter )
+	{
+		case 'L': return "TURN_LEFT";
+		case 'R': return "TURN_RIGHT";
+		case 'F': return "FORWARD";
+		case 'S': return "SHOOT";
+		case 'G': return "GRAB";
+		case 'C': return "CLIMB";
+		default:  return "nothing";
+	}
+}
+
+// Reads a fingerprint file into traces by world name
+static bool readFingerprints ( const string& path, unordered_map<string, Trace>& traces )
+{
+	ifstream file ( path );
+	if ( !file )
+		return false;
+
+	string	name;
+	size_t	steps;
+	Trace	trace;
+	while ( file >> name >> trace.score >> steps >> hex >> trace.hash >> dec >> trace.actions )
+	{
+		if ( trace.actions.size() != steps )
+			return false;
+		traces[name] = trace;
+	}
+	return file.eof();
+}
+
+int runFingerprint ( int argc, char* argv[] )
+{
+	if ( argc < 2 )
+	{
+		cout << "[ERROR] Usage: fingerprint Agent Suite [Options]" << endl;
+		return 0;
+	}
+
+	string		agentName = argv[0];
+	string		path      = argv[1];
+	uint64_t	seed      = 0;
+	string		output, baselinePath;
+
+	for ( int index = 2; index < argc; ++index )
+	{
+		string token = argv[index];
+
+		if ( token == "--seed" && index + 1 < argc )
+			seed = strtoull ( argv[++index], NULL, 10 );
+		else if ( token == "--write" && index + 1 < argc )
+			output = argv[++index];
+		else if ( token == "--baseline" && index + 1 < argc )
+			baselinePath = argv[++index];
+		else
+		{
+			cout << "[ERROR] Unknown fingerprint option " << token << "." << endl;
+			return 0;
+		}
+	}
+
+	Agent* agent = AgentRegistry::make ( agentName );
+	if ( agent == NULL )
+	{
+		cout << "[ERROR] Unknown agent " << agentName << "." << endl;
+		return 0;
+	}
+
+	Trace	trace;
+	Player	player ( new RecordingAgent ( agent, &trace ) );
+
+	Suite suite;
+	if ( !loadSuite ( path, suite ) || suite.worlds.empty() )
+	{
+		cout << "[ERROR] Failed to load suite " << path << "." << endl;
+		return 0;
+	}
+
+	unordered_map<string, Trace> baseline;
+	if ( !baselinePath.empty() && !readFingerprints ( baselinePath, baseline ) )
+	{
+		cout << "[ERROR] Failed to read fingerprints from " << baselinePath << "." << endl;
+		return 0;
+	}
+
+	ofstream file;
+	if ( !output.empty() )
+	{
+		file.open ( output );
+		if ( !file )
+		{
+			cout << "[ERROR] Failed to open " << output << " for writing." << endl;
+			return 0;
+		}
+	}
+
+	size_t played = 0, failures = 0, diverged = 0, matched = 0;
+	for ( size_t index = 0; index < suite.worlds.size(); ++index )
+	{
+		const string& name = suite.names[index];
+
+		trace.clear();
+		try
+		{
+			trace.score = player.play ( suite.worlds[index], Hash::fnv1a ( name, seed ) );
+		}
+		catch (...)
+		{
+			cout << "[WARNING] " << name << " failed; it has no fingerprint." << endl;
+			++failures;
+			continue;
+		}
+		++played;
+
+		if ( file.is_open() )
+			file << name << " " << trace.score << " " << trace.actions.size() << " "
+				 << hex << trace.hash << dec << " " << trace.actions << "\n";
+
+		auto found = baseline.find ( name );
+		if ( found == baseline.end() )
+			continue;
+
+		const Trace& before = found->second;
+		if ( before.hash == trace.hash && before.actions == trace.actions )
+			++matched;
+		else
+		{
+			size_t step = 0;
+			while ( step < before.actions.size() && step < trace.actions.size() && before.actions[step] == trace.actions[step] )
+				++step;
+
+			cout << "DIVERGED " << name << " at step " << step << ": baseline "
+				 << actionName ( step < before.actions.size() ? before.actions[step] : 0 ) << ", now "
+				 << actionName ( step < trace.actions.size() ? trace.actions[step] : 0 )
+				 << " (score " << before.score << " -> " << trace.score << ")" << endl;
+			++diverged;
+		}
+		baseline.erase ( found );
+	}
+
+	cout << "Fingerprinted " << played << " worlds";
+	if ( failures > 0 )
+		cout << " (" << failures << " failed)";
+	cout << "." << endl;
+
+	if ( baselinePath.empty() )
+		return 0;
+
+	vector<string> missing;
+	for ( const auto& entry : baseline )
+		missing.push_back ( entry.first );
+	sort ( missing.begin(), missing.end() );
+	for ( const string& name : missing )
+		cout << "MISSING " << name << endl;
+
+	cout << matched << " match the baseline, " << diverged << " diverged, "
+		 << baseline.size() << " missing." << endl;
+	return diverged == 0 && baseline.empty() ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+// ======================================================================
+// FILE:        Fingerprint.hpp
+//
+// DESCRIPTION: This file contains the fingerprint mode, which records
+//              every action an agent takes on every world of a suite and
+//              checks the record against a baseline. Equal fingerprints
+//              mean the agent made the same decisions, which a matching
+//              average score does not prove; a refactor of the agent for
+//              speed should leave them unchanged.
+//
+// NOTES:       - Syntax:
+//
+//                  Wumpus_World fingerprint Agent Suite [Options]
+//
+//                  Agent is an AgentRegistry name; Suite is a folder or a
+//                  packed suite file (see Suite.hpp).
+//
+//                  Options:
+//                      --seed S        Seed; each world's game is seeded
+//                                      as by -f --seed S. Default 0.
+//                      --write PATH    Write the fingerprints to PATH.
+//                      --baseline PATH Compare with the fingerprints in
+//                                      PATH, written earlier by --write.
+//
+//              - A fingerprint is one line per world:
+//
+//                  <world> <score> <steps> <hash> <actions>
+//
+//                where hash is the FNV-1a hash of the action sequence in
+//                hexadecimal and actions spells the sequence with one
+//                letter per action (L, R, F, S, G, C for TURN_LEFT,
+//                TURN_RIGHT, FORWARD, SHOOT, GRAB, CLIMB).
+//
+//              - Against a baseline, every world whose hash differs is
+//                reported with the first step where the actions differ,
+//                and every baseline world that was not played is
+//                reported as missing. Exits with status 1 if there is
+//                either.
+// ======================================================================
+
+#ifndef FINGERPRINT_LOCK
+#define FINGERPRINT_LOCK
+
+// Runs the fingerprint subcommand on the arguments that follow it
+int runFingerprint ( int argc, char* argv[] );
+
+#endif /* FINGERPRINT_LOCK */
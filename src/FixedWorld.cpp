@@ -0,0 +1,93 @@
+// ======================================================================
+// FILE:        FixedWorld.cpp
+//
+// DESCRIPTION: This file contains the run-time dispatch to the FixedWorld
+//              instantiations.
+// ======================================================================
+
+#include "FixedWorld.hpp"
+
+#include <utility>
+
+namespace
+{
+	typedef int ( *Player ) ( const WorldDescription&, Agent&, SpatialStats* );
+	typedef FixedGame* ( *Maker ) ( const WorldDescription& );
+
+	template <int Cols, int Rows>
+	int play ( const WorldDescription& description, Agent& agent, SpatialStats* analytics )
+	{
+		FixedWorld<Cols, Rows> world ( description );
+		if ( analytics )
+		{
+			analytics->startGame();
+			world.setAnalytics ( analytics );
+		}
+		return world.run ( agent );
+	}
+
+	template <int Cols, int Rows>
+	class SizedGame : public FixedGame
+	{
+	public:
+		explicit SizedGame ( const WorldDescription& description ) : world ( description ) {}
+
+		bool	step		( Agent& agent )	{ return world.step ( agent ); }
+		int		getScore	( void ) const		{ return world.getScore(); }
+
+	private:
+		FixedWorld<Cols, Rows> world;
+	};
+
+	template <int Cols, int Rows>
+	FixedGame* make ( const WorldDescription& description )
+	{
+		return new SizedGame<Cols, Rows> ( description );
+	}
+
+	const int SIZES = MAX_FIXED - MIN_FIXED + 1;
+
+	// players[i] and makers[i] handle boards with MIN_FIXED + i / SIZES
+	// columns and MIN_FIXED + i % SIZES rows
+	template <int... Index>
+	constexpr std::array<Player, sizeof... ( Index )> makePlayers ( std::integer_sequence<int, Index...> )
+	{
+		return { { &play<MIN_FIXED + Index / SIZES, MIN_FIXED + Index % SIZES>... } };
+	}
+
+	template <int... Index>
+	constexpr std::array<Maker, sizeof... ( Index )> makeMakers ( std::integer_sequence<int, Index...> )
+	{
+		return { { &make<MIN_FIXED + Index / SIZES, MIN_FIXED + Index % SIZES>... } };
+	}
+
+	constexpr std::array<Player, SIZES * SIZES> players = makePlayers ( std::make_integer_sequence<int, SIZES * SIZES>() );
+	constexpr std::array<Maker,  SIZES * SIZES> makers  = makeMakers  ( std::make_integer_sequence<int, SIZES * SIZES>() );
+
+	// Index into players and makers, or -1 if no FixedWorld covers the size
+	int sizeIndex ( const WorldDescription& description )
+	{
+		int c = description.colDimension - MIN_FIXED;
+		int r = description.rowDimension - MIN_FIXED;
+
+		if ( c < 0 || c >= SIZES || r < 0 || r >= SIZES )
+			return -1;
+		return c * SIZES + r;
+	}
+}
+
+bool playFixed ( const WorldDescription& description, Agent& agent, int& score, SpatialStats* analytics )
+{
+	int index = sizeIndex ( description );
+	if ( index < 0 )
+		return false;
+
+	score = players[index] ( description, agent, analytics );
+	return true;
+}
+
+FixedGame* makeFixedGame ( const WorldDescription& description )
+{
+	int index = sizeIndex ( description );
+	return index < 0 ? NULL : makers[index] ( description );
+}
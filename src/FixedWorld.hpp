@@ -0,0 +1,284 @@
+// ======================================================================
+// FILE:        FixedWorld.hpp
+//
+// DESCRIPTION: This file contains FixedWorld, a version of the World
+//              engine specialised at compile time for one board size.
+//              Each feature of the board is a bitmask with one bit per
+//              cell, bounds checks compare against constants, and the
+//              arrow's flight is a single AND with a precomputed ray
+//              mask instead of a loop over the row or column.
+//
+// NOTES:       - FixedWorld plays exactly the same game as World::run(),
+//                score for score, but has none of its extras (debug
+//                display, prefix cache, time budgets). Callers that need
+//                those use World.
+//
+//              - playFixed() picks the instantiation for the board's
+//                dimensions at run time. Boards from MIN_FIXED to
+//                MAX_FIXED in each dimension are covered; for any other
+//                size it returns false and the caller falls back to
+//                World.
+//
+//              - step() plays a single turn, so a caller can advance
+//                many games in turn on one thread (see Interleave.hpp).
+//                makeFixedGame() hides the size behind FixedGame for
+//                that purpose.
+//
+//              - With a SpatialStats attached (see Analytics.hpp), the
+//                game records its moves, bumps, deaths and missed shots
+//                into it, exactly as World::run() does.
+// ======================================================================
+
+#ifndef FIXEDWORLD_LOCK
+#define FIXEDWORLD_LOCK
+
+#include <array>
+#include <cstdint>
+#include "Agent.hpp"
+#include "Analytics.hpp"
+#include "Compass.hpp"
+#include "WorldDescription.hpp"
+
+template <int Cols, int Rows>
+class FixedWorld
+{
+	static_assert ( Cols * Rows <= 64, "FixedWorld boards must fit in a 64-bit mask" );
+
+public:
+
+	explicit FixedWorld ( const WorldDescription& description )
+	{
+		addWumpus ( description.wumpus.c, description.wumpus.r );
+		addGold ( description.gold.c, description.gold.r );
+		for ( const WorldDescription::Cell& pit : description.pits )
+			addPit ( pit.c, pit.r );
+	}
+
+	// Records the rest of the game into 'stats', which the caller has
+	// already counted the game in (see SpatialStats::startGame); NULL
+	// stops recording
+	void setAnalytics ( SpatialStats* stats )
+	{
+		analytics = stats;
+	}
+
+	int run ( Agent& agent )
+	{
+		while ( step ( agent ) )
+			;
+		return score;
+	}
+
+	// Plays one turn. Returns false once the game is over, after which
+	// getScore() is final and step() does nothing.
+	bool step ( Agent& agent )
+	{
+		if ( over )
+			return false;
+
+		uint64_t here = bit ( agentX, agentY );
+
+		Agent::Action action = agent.getAction
+		(
+			stench & here,
+			breeze & here,
+			gold & here,
+			bump,
+			scream
+		);
+
+		--score;
+		bump   = false;
+		scream = false;
+
+		switch ( action )
+		{
+			case Agent::TURN_LEFT:
+				agentDir = Compass::LEFT_OF[agentDir];
+				break;
+
+			case Agent::TURN_RIGHT:
+				agentDir = Compass::RIGHT_OF[agentDir];
+				break;
+
+			case Agent::FORWARD:
+			{
+				int x = agentX + Compass::DX[agentDir];
+				int y = agentY + Compass::DY[agentDir];
+				if ( isInBounds ( x, y ) )
+				{
+					agentX = x;
+					agentY = y;
+					if ( analytics )
+						analytics->visit ( agentX, agentY );
+				}
+				else
+				{
+					bump = true;
+					if ( analytics )
+						analytics->bump ( agentX, agentY );
+				}
+
+				if ( ( pits | wumpus ) & bit ( agentX, agentY ) )
+				{
+					score -= 1000;
+					over   = true;
+					if ( analytics )
+						analytics->died ( agentX, agentY, pits & bit ( agentX, agentY ) );
+				}
+				break;
+			}
+
+			case Agent::SHOOT:
+				if ( hasArrow )
+				{
+					hasArrow = false;
+					score -= 10;
+
+					// The arrow flies from the agent's cell to the wall
+					uint64_t hit = wumpus & rays[ ( bitIndex ( agentX, agentY ) << 2 ) | agentDir ];
+					if ( hit )
+					{
+						wumpus &= ~hit;
+						stench |= hit;
+						scream  = true;
+					}
+					else if ( analytics )
+						analytics->missed ( agentX, agentY );
+				}
+				break;
+
+			case Agent::GRAB:
+				if ( gold & here )
+				{
+					gold &= ~here;
+					goldLooted = true;
+				}
+				break;
+
+			case Agent::CLIMB:
+				if ( agentX == 0 && agentY == 0 )
+				{
+					if ( goldLooted )
+						score += 1000;
+					over = true;
+				}
+				break;
+		}
+
+		// Same limit as World::run()
+		if ( score < -1000 )
+			over = true;
+		return !over;
+	}
+
+	int getScore ( void ) const { return score; }
+
+private:
+
+	// Board Variables, one bit per cell
+	uint64_t	pits   = 0;
+	uint64_t	wumpus = 0;
+	uint64_t	gold   = 0;
+	uint64_t	breeze = 0;
+	uint64_t	stench = 0;
+
+	// Agent Variables
+	int		score      = 0;
+	bool	over       = false;		// Climbed out, died or ran out of points
+	bool	goldLooted = false;
+	bool	hasArrow   = true;
+	bool	bump       = false;
+	bool	scream     = false;
+	int		agentDir   = 0;		// 0 - right, 1 - down, 2 - left, 3 - up
+	int		agentX     = 0;
+	int		agentY     = 0;
+
+	SpatialStats*	analytics = NULL;	// Where to record the game, if anywhere
+
+	static constexpr int bitIndex ( int c, int r ) { return r * Cols + c; }
+	static constexpr uint64_t bit ( int c, int r ) { return uint64_t ( 1 ) << bitIndex ( c, r ); }
+	static constexpr bool isInBounds ( int c, int r ) { return c >= 0 && c < Cols && r >= 0 && r < Rows; }
+
+	// rays[(cell << 2) | dir] holds the cells an arrow shot from 'cell'
+	// towards 'dir' passes through, the shooter's own cell included
+	static constexpr std::array<uint64_t, Cols * Rows * 4> makeRays ( void )
+	{
+		std::array<uint64_t, Cols * Rows * 4> table {};
+
+		for ( int r = 0; r < Rows; ++r )
+			for ( int c = 0; c < Cols; ++c )
+				for ( int d = 0; d < 4; ++d )
+				{
+					uint64_t ray = 0;
+					for ( int x = c, y = r; isInBounds ( x, y ); x += Compass::DX[d], y += Compass::DY[d] )
+						ray |= bit ( x, y );
+					table[ ( bitIndex ( c, r ) << 2 ) | d ] = ray;
+				}
+		return table;
+	}
+
+	static constexpr std::array<uint64_t, Cols * Rows * 4> rays = makeRays();
+
+	// Bits of the in-bounds orthogonal neighbours of (c, r)
+	static uint64_t neighbours ( int c, int r )
+	{
+		uint64_t cells = 0;
+		if ( isInBounds ( c + 1, r ) ) cells |= bit ( c + 1, r );
+		if ( isInBounds ( c - 1, r ) ) cells |= bit ( c - 1, r );
+		if ( isInBounds ( c, r + 1 ) ) cells |= bit ( c, r + 1 );
+		if ( isInBounds ( c, r - 1 ) ) cells |= bit ( c, r - 1 );
+		return cells;
+	}
+
+	void addPit ( int c, int r )
+	{
+		if ( isInBounds ( c, r ) )
+		{
+			pits   |= bit ( c, r );
+			breeze |= neighbours ( c, r );
+		}
+	}
+
+	void addWumpus ( int c, int r )
+	{
+		if ( isInBounds ( c, r ) )
+		{
+			wumpus |= bit ( c, r );
+			stench |= neighbours ( c, r );
+		}
+	}
+
+	void addGold ( int c, int r )
+	{
+		if ( isInBounds ( c, r ) )
+			gold |= bit ( c, r );
+	}
+};
+
+template <int Cols, int Rows>
+constexpr std::array<uint64_t, Cols * Rows * 4> FixedWorld<Cols, Rows>::rays;
+
+// The board sizes playFixed() has an instantiation for
+const int MIN_FIXED = 4;
+const int MAX_FIXED = 7;
+
+// Plays the described world with the FixedWorld matching its size and
+// stores the score, recording the game into 'analytics' if given.
+// Returns false, without playing, if no FixedWorld covers the size.
+bool playFixed ( const WorldDescription& description, Agent& agent, int& score, SpatialStats* analytics = NULL );
+
+// A FixedWorld of any size, played one turn at a time
+class FixedGame
+{
+public:
+	virtual bool	step		( Agent& agent ) = 0;
+	virtual int		getScore	( void ) const = 0;
+	virtual ~FixedGame() {}
+};
+
+// Returns a heap-allocated game of the described world, or NULL if no
+// FixedWorld covers its size
+FixedGame* makeFixedGame ( const WorldDescription& description );
+
+#endif /* FIXEDWORLD_LOCK */
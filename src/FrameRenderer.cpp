@@ -0,0 +1,113 @@
+// ======================================================================
+// FILE:        FrameRenderer.cpp
+//
+// DESCRIPTION: This file contains the frame renderer, which carries the
+//              debug display of a World to the terminal.
+// ======================================================================
+
+#include "FrameRenderer.hpp"
+
+#include <iostream>
+#include <thread>
+#include <cerrno>
+#include <unistd.h>
+
+using namespace std;
+
+FrameRenderer::FrameRenderer ( int _fps, size_t _tailFrames, int _fd )
+	: fps ( _fps ), tailFrames ( _tailFrames ), fd ( _fd ), out ( NULL ), in ( &cin ),
+	  tail ( _tailFrames ), tailNext ( 0 ), tailCount ( 0 ),
+	  nextFrameTime ( chrono::steady_clock::now() )
+{
+	frame.reserve ( 4096 );
+}
+
+FrameRenderer::FrameRenderer ( ostream& _out, istream& _in, int _fps, size_t _tailFrames )
+	: FrameRenderer ( _fps, _tailFrames )
+{
+	out = &_out;
+	in  = &_in;
+}
+
+string& FrameRenderer::beginFrame ( void )
+{
+	if ( tailFrames > 0 )
+	{
+		// Draw straight into the ring slot; clear() keeps the slot's
+		// capacity, so steady state allocates nothing
+		string& slot = tail[tailNext];
+		slot.clear();
+		return slot;
+	}
+
+	frame.clear();
+	return frame;
+}
+
+void FrameRenderer::endFrame ( bool interactive, bool last )
+{
+	if ( tailFrames > 0 )
+	{
+		tailNext = ( tailNext + 1 ) % tailFrames;
+		if ( tailCount < tailFrames )
+			++tailCount;
+		return;
+	}
+
+	bool pause = interactive && !last && fps <= 0;
+	if ( pause )
+		frame.append ( "Press ENTER to continue...\n" );
+
+	writeAll ( frame );
+
+	if ( pause )
+		in->ignore ( 999, '\n' );
+	else if ( interactive && fps > 0 )
+	{
+		nextFrameTime += chrono::microseconds ( 1000000 / fps );
+		auto now = chrono::steady_clock::now();
+		if ( nextFrameTime < now )
+			nextFrameTime = now;
+		else
+			this_thread::sleep_until ( nextFrameTime );
+	}
+}
+
+void FrameRenderer::finish ( void )
+{
+	size_t first = ( tailNext + tailFrames - tailCount ) % ( tailFrames ? tailFrames : 1 );
+	for ( size_t i = 0; i < tailCount; ++i )
+		writeAll ( tail[ ( first + i ) % tailFrames ] );
+
+	tailNext  = 0;
+	tailCount = 0;
+}
+
+void FrameRenderer::writeAll ( const string& text )
+{
+	if ( out )
+	{
+		out->write ( text.data(), text.size() );
+		out->flush();
+		return;
+	}
+
+	// Anything still sitting in cout's buffer belongs before this frame
+	cout.flush();
+
+	const char*	data      = text.data();
+	size_t		remaining = text.size();
+
+	while ( remaining > 0 )
+	{
+		ssize_t written = ::write ( fd, data, remaining );
+		if ( written < 0 )
+		{
+			if ( errno == EINTR )
+				continue;
+			return;
+		}
+		data      += written;
+		remaining -= written;
+	}
+}
@@ -0,0 +1,76 @@
+// ======================================================================
+// FILE:        FrameRenderer.hpp
+//
+// DESCRIPTION: This file contains the frame renderer, which carries the
+//              debug display of a World to the terminal. The World draws
+//              each frame into the renderer's reusable text buffer, and
+//              the renderer writes the finished frame with a single
+//              write() call instead of one stream operation per tile.
+//
+// NOTES:       - Pacing modes:
+//
+//                  Interactive (default): after each frame, wait for
+//                  ENTER, like the original debug mode.
+//
+//                  Frame rate (fps > 0): advance automatically, holding
+//                  each frame for 1/fps seconds.
+//
+//                  Tail (tailFrames > 0): keep only the last tailFrames
+//                  frames in memory and write them when the game ends.
+//                  Never waits.
+//
+//              - With the manual agent, frames are written immediately
+//                and never paced; ManualAI's prompt already waits. Tail
+//                mode would hold the frames back from the player, so the
+//                command line rejects --tail with -m.
+//
+//              - By default frames go straight to a file descriptor and
+//                the interactive pause reads std::cin. A renderer built
+//                on streams uses only those streams, so Worlds rendering
+//                on different threads share nothing.
+// ======================================================================
+
+#ifndef FRAMERENDERER_LOCK
+#define FRAMERENDERER_LOCK
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <istream>
+#include <ostream>
+
+class FrameRenderer
+{
+public:
+
+	FrameRenderer ( int fps = 0, size_t tailFrames = 0, int fd = 1 );
+	FrameRenderer ( std::ostream& out, std::istream& in, int fps = 0, size_t tailFrames = 0 );
+
+	// Clears and returns the buffer the next frame is drawn into
+	std::string&	beginFrame	( void );
+
+	// Emits the frame drawn since beginFrame() according to the pacing
+	// mode. 'last' marks the final frame of a game, which is never paused.
+	void	endFrame	( bool interactive, bool last = false );
+
+	// Writes out any frames held back in tail mode
+	void	finish		( void );
+
+private:
+	int		fps;			// Frames per second, or 0 to not auto-advance
+	size_t	tailFrames;		// Frames kept for the end of game, or 0 to write as we go
+	int		fd;				// Where frames are written when 'out' is NULL
+	std::ostream*	out;	// Where frames are written, or NULL to use 'fd'
+	std::istream*	in;		// Where the interactive pause reads ENTER from
+
+	std::string					frame;		// The frame being drawn
+	std::vector<std::string>	tail;		// Ring of the most recent frames in tail mode
+	size_t						tailNext;	// Next slot to overwrite in 'tail'
+	size_t						tailCount;	// Number of valid frames in 'tail'
+
+	std::chrono::steady_clock::time_point	nextFrameTime;
+
+	void	writeAll	( const std::string& text );
+};
+
+#endif /* FRAMERENDERER_LOCK */
@@ -0,0 +1,214 @@
+// ======================================================================
+// FILE:        Generator.cpp
+//
+// DESCRIPTION: This file contains the world suite generator, which
+//              writes benchmark folders for -f mode.
+// ======================================================================
+
+#include "Generator.hpp"
+#include "WorldDescription.hpp"
+#include "Random.hpp"
+#include "Hash.hpp"
+#include "Affinity.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <unordered_set>
+#include <algorithm>
+#include <ctime>
+#include <cstdlib>
+#include <sys/stat.h>
+
+using namespace std;
+
+struct GeneratorOptions
+{
+	int			minSize    = 4;
+	int			maxSize    = 7;
+	double		pitDensity = 0.2;
+	bool		solvable   = false;
+	bool		packed     = false;
+	uint64_t	seed       = time ( NULL );
+	int			threads    = Affinity::defaultThreads();
+	bool		pin        = false;
+};
+
+// Draws candidate 'index' of the suite. Follows the random world rules
+// of World::addFeatures: pits anywhere but the start, then a wumpus and
+// the gold anywhere but the start.
+static WorldDescription drawWorld ( const GeneratorOptions& options, uint64_t index )
+{
+	SplitMix64			random ( Hash::fnv1a ( &index, sizeof index, options.seed ) );
+	WorldDescription	world;
+
+	world.colDimension = options.minSize + random.uniform ( options.maxSize - options.minSize + 1 );
+	world.rowDimension = options.minSize + random.uniform ( options.maxSize - options.minSize + 1 );
+
+	for ( int r = 0; r < world.rowDimension; ++r )
+		for ( int c = 0; c < world.colDimension; ++c )
+			if ( ( c != 0 || r != 0 ) && random.real() < options.pitDensity )
+				world.pits.push_back ( { c, r } );
+
+	do
+		world.wumpus = { random.uniform ( world.colDimension ), random.uniform ( world.rowDimension ) };
+	while ( world.wumpus.c == 0 && world.wumpus.r == 0 );
+
+	do
+		world.gold = { random.uniform ( world.colDimension ), random.uniform ( world.rowDimension ) };
+	while ( world.gold.c == 0 && world.gold.r == 0 );
+
+	return world;
+}
+
+// Runs body(i) for i in [begin, end), one contiguous block per worker
+// thread, so neighbouring results are written by the same core. The
+// workers are pinned when given a placement.
+template <class Body>
+static void parallelFor ( int threads, const Affinity::Placement* placement, size_t begin, size_t end, Body body )
+{
+	vector<thread> workers;
+	for ( int t = 0; t < threads; ++t )
+		workers.emplace_back ( [=]
+		{
+			if ( placement != NULL )
+				Affinity::pinWorker ( *placement, t, threads );
+			size_t first = begin + ( end - begin ) * t / threads;
+			size_t last  = begin + ( end - begin ) * ( t + 1 ) / threads;
+			for ( size_t i = first; i < last; ++i )
+				body ( i );
+		} );
+
+	for ( thread& worker : workers )
+		worker.join();
+}
+
+int generateSuite ( int argc, char* argv[] )
+{
+	if ( argc < 2 )
+	{
+		cout << "Wumpus_World generate Folder Count [--size MIN MAX] [--pits P]" << endl;
+		cout << "                      [--solvable] [--packed] [--seed S] [--threads T] [--pin]" << endl;
+		return 0;
+	}
+
+	string				folder = argv[0];
+	size_t				count  = strtoul ( argv[1], NULL, 10 );
+	GeneratorOptions	options;
+
+	for ( int index = 2; index < argc; ++index )
+	{
+		string token = argv[index];
+
+		if ( token == "--size" && index + 2 < argc )
+		{
+			options.minSize = atoi ( argv[++index] );
+			options.maxSize = atoi ( argv[++index] );
+		}
+		else if ( token == "--pits" && index + 1 < argc )
+			options.pitDensity = atof ( argv[++index] );
+		else if ( token == "--solvable" )
+			options.solvable = true;
+		else if ( token == "--packed" )
+			options.packed = true;
+		else if ( token == "--seed" && index + 1 < argc )
+			options.seed = strtoull ( argv[++index], NULL, 10 );
+		else if ( token == "--threads" && index + 1 < argc )
+			options.threads = max ( 1, atoi ( argv[++index] ) );
+		else if ( token == "--pin" )
+			options.pin = true;
+		else
+		{
+			cout << "[ERROR] Unknown generate option " << token << "." << endl;
+			return 0;
+		}
+	}
+
+	// The wumpus and the gold are drawn off the start cell, so a board
+	// needs another cell
+	if ( options.minSize < 2 || options.maxSize > WorldDescription::MAX_DIMENSION || options.minSize > options.maxSize )
+	{
+		cout << "[ERROR] --size must be within 2.." << WorldDescription::MAX_DIMENSION << "." << endl;
+		return 0;
+	}
+
+	mkdir ( folder.c_str(), 0777 );
+
+	Affinity::Placement			placement;
+	const Affinity::Placement*	pinning = NULL;
+	if ( options.pin )
+	{
+		placement = Affinity::placement();
+		pinning   = &placement;
+	}
+
+	// Draw candidates in parallel batches, then accept them in index
+	// order so the result is independent of scheduling
+	vector<WorldDescription>	suite;
+	unordered_set<uint64_t>		seen;
+	size_t	candidates = 0, duplicates = 0, unsolvable = 0;
+	size_t	batchSize  = max<size_t> ( 1024, count );
+
+	while ( suite.size() < count )
+	{
+		// Give up if the space of distinct worlds is exhausted
+		if ( candidates > 0 && candidates >= 64 * max<size_t> ( count, 1024 ) )
+		{
+			cout << "[WARNING] Only found " << suite.size() << " distinct worlds." << endl;
+			break;
+		}
+
+		vector<WorldDescription>	batch ( batchSize );
+		vector<uint64_t>			keys ( batchSize );
+		vector<char>				keep ( batchSize );
+
+		parallelFor ( options.threads, pinning, 0, batchSize, [&] ( size_t i )
+		{
+			batch[i] = drawWorld ( options, candidates + i );
+			keep[i]  = !options.solvable || batch[i].isSolvable();
+			keys[i]  = batch[i].canonicalKey();
+		} );
+
+		for ( size_t i = 0; i < batchSize && suite.size() < count; ++i )
+		{
+			++candidates;
+			if ( !keep[i] )
+				++unsolvable;
+			else if ( !seen.insert ( keys[i] ).second )
+				++duplicates;
+			else
+				suite.push_back ( move ( batch[i] ) );
+		}
+	}
+
+	bool failed = false;
+	if ( options.packed )
+	{
+		ofstream file ( folder + "/worlds.pack", ios::binary );
+		WorldDescription::writePacked ( file, suite );
+		failed = !file;
+	}
+	else
+	{
+		vector<char> written ( suite.size() );
+		parallelFor ( options.threads, pinning, 0, suite.size(), [&] ( size_t i )
+		{
+			ofstream file ( folder + "/world_" + to_string ( i ) + ".txt" );
+			suite[i].write ( file );
+			written[i] = bool ( file );
+		} );
+		failed = find ( written.begin(), written.end(), 0 ) != written.end();
+	}
+
+	if ( failed )
+	{
+		cout << "[ERROR] Failed to write worlds to " << folder << "." << endl;
+		return 0;
+	}
+
+	cout << "Generated " << suite.size() << " worlds from " << candidates << " candidates ("
+		 << duplicates << " duplicates, " << unsolvable << " unsolvable)." << endl;
+	return 0;
+}
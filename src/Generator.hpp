@@ -0,0 +1,44 @@
+// ======================================================================
+// FILE:        Generator.hpp
+//
+// DESCRIPTION: This file contains the world suite generator, which
+//              writes benchmark folders for -f mode.
+//
+// NOTES:       - Syntax:
+//
+//                  Wumpus_World generate Folder Count [Options]
+//
+//                  Options:
+//                      --size MIN MAX  Columns and rows are each picked
+//                                      uniformly from MIN..MAX, within
+//                                      2..MAX_DIMENSION. Default 4 7.
+//                      --pits P        Chance of a pit on each cell other
+//                                      than the start. Default 0.2.
+//                      --solvable      Only keep worlds where a safe path
+//                                      leads from the start to the gold.
+//                      --packed        Write one packed file,
+//                                      Folder/worlds.pack, instead of one
+//                                      text file per world. -f and the
+//                                      suite modes read it from Folder.
+//                      --seed S        Seed; the same seed and options
+//                                      always give the same suite.
+//                      --threads T     Worker threads. Default: one per
+//                                      usable CPU (see Affinity.hpp).
+//                      --pin           Pin each worker to its own CPU.
+//
+//              - Worlds that are duplicates, or mirror images along the
+//                diagonal through the start, of a world already in the
+//                suite are dropped (see WorldDescription::canonicalKey).
+//
+//              - Candidate i is drawn from its own generator seeded by
+//                (seed, i), and candidates are accepted in index order,
+//                so the suite does not depend on the thread count.
+// ======================================================================
+
+#ifndef GENERATOR_LOCK
+#define GENERATOR_LOCK
+
+// Runs the generate subcommand on the arguments that follow it
+int generateSuite ( int argc, char* argv[] );
+
+#endif /* GENERATOR_LOCK */
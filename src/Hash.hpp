@@ -0,0 +1,42 @@
+// ======================================================================
+// FILE:        Hash.hpp
+//
+// DESCRIPTION: This file contains the 64-bit FNV-1a hash used wherever
+//              the program needs a hash that is stable across runs,
+//              builds and machines (sharding, caches, fingerprints).
+//              std::hash makes no such promise.
+// ======================================================================
+
+#ifndef HASH_LOCK
+#define HASH_LOCK
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace Hash
+{
+	const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+	const uint64_t FNV_PRIME  = 1099511628211ULL;
+
+	// Folds one byte into a running hash
+	inline uint64_t fnv1a ( uint64_t hash, unsigned char byte )
+	{
+		return ( hash ^ byte ) * FNV_PRIME;
+	}
+
+	inline uint64_t fnv1a ( const void* data, size_t length, uint64_t hash = FNV_OFFSET )
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*> ( data );
+		for ( size_t i = 0; i < length; ++i )
+			hash = fnv1a ( hash, bytes[i] );
+		return hash;
+	}
+
+	inline uint64_t fnv1a ( const std::string& text, uint64_t hash = FNV_OFFSET )
+	{
+		return fnv1a ( text.data(), text.size(), hash );
+	}
+}
+
+#endif /* HASH_LOCK */
@@ -0,0 +1,60 @@
+// ======================================================================
+// FILE:        Interleave.cpp
+//
+// DESCRIPTION: This file contains playInterleaved(), which plays many
+//              games on one thread, one turn of each in turn.
+// ======================================================================
+
+#include "Interleave.hpp"
+#include "FixedWorld.hpp"
+
+#include <memory>
+
+using namespace std;
+
+bool playInterleaved
+(
+	const vector<WorldDescription>&		worlds,
+	const function<Agent* ( void )>&	makeAgent,
+	vector<int>&						scores
+)
+{
+	struct Game
+	{
+		unique_ptr<FixedGame>	world;
+		unique_ptr<Agent>		agent;
+		size_t					index;		// Position in worlds and scores
+	};
+
+	vector<Game> active;
+	active.reserve ( worlds.size() );
+	for ( size_t i = 0; i < worlds.size(); ++i )
+	{
+		unique_ptr<FixedGame> world ( makeFixedGame ( worlds[i] ) );
+		if ( !world )
+			return false;
+		active.push_back ( { move ( world ), unique_ptr<Agent> ( makeAgent() ), i } );
+	}
+
+	scores.assign ( worlds.size(), 0 );
+
+	// One turn of every unfinished game per pass. A finished game is
+	// replaced by the last one, so the list stays dense.
+	while ( !active.empty() )
+		for ( size_t i = 0; i < active.size(); )
+		{
+			Game& game = active[i];
+			if ( game.world->step ( *game.agent ) )
+			{
+				++i;
+				continue;
+			}
+
+			scores[game.index] = game.world->getScore();
+			if ( i + 1 != active.size() )
+				game = move ( active.back() );
+			active.pop_back();
+		}
+
+	return true;
+}
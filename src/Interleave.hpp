@@ -0,0 +1,42 @@
+// ======================================================================
+// FILE:        Interleave.hpp
+//
+// DESCRIPTION: This file contains playInterleaved(), which plays many
+//              games on the calling thread, one turn of each in turn,
+//              instead of one game after another.
+//
+// NOTES:       - Every game keeps its own agent, so an agent never sees
+//                another game's percepts. Unless the agents share state,
+//                the scores are those of playing the games one by one.
+//
+//              - Interleaving pays off for agents that suspend between
+//                turns, such as coroutine agents (see CoroutineAgent.hpp):
+//                a turn costs a resume instead of a fresh pass through
+//                the agent's decision logic, and thousands of games can
+//                be in flight without a thread each.
+//
+//              - The stress test checks interleaved scores against games
+//                played one by one for every registered agent (see
+//                Stress.hpp).
+// ======================================================================
+
+#ifndef INTERLEAVE_LOCK
+#define INTERLEAVE_LOCK
+
+#include <functional>
+#include <vector>
+#include "Agent.hpp"
+#include "WorldDescription.hpp"
+
+// Plays every world with a heap-allocated agent from makeAgent and stores
+// the scores in world order. Returns false, without playing, if a world
+// has no FixedWorld for its size. Exceptions from an agent propagate and
+// abandon the remaining games.
+bool playInterleaved
+(
+	const std::vector<WorldDescription>&	worlds,
+	const std::function<Agent* ( void )>&	makeAgent,
+	std::vector<int>&						scores
+);
+
+#endif /* INTERLEAVE_LOCK */
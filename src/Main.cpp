@@ -27,6 +27,116 @@
 //                         display the average score and standard
 //                         deviation instead of a single score. InputFile
 //                         must be entered with this option.
+//                      -c Prefix cache mode, which memoises MyAI's
+//                         decisions by percept history and replays them
+//                         across the worlds of a folder. Only useful
+//                         with -f.
+//
+//                  Long Options (anywhere on the command line):
+//                      --fps N  With -d, advance automatically at N frames
+//                               per second instead of waiting for ENTER.
+//                      --tail N With -d, keep only the last N frames of
+//                               each game and print them when it ends.
+//                               Not allowed with -m.
+//                      --dedupe With -f and a deterministic agent, play
+//                               each distinct board once and count its
+//                               score for every copy (see Evaluator.hpp).
+//                      --shard I/N With -f, run only the worlds whose file
+//                               name hashes to shard I of N (0 <= I < N)
+//                               and write mergeable statistics (see
+//                               Statistics.hpp) instead of a plain score.
+//                      --move-budget US Flag every agent move that takes
+//                               longer than US microseconds.
+//                      --game-budget MS Flag games where the agent spends
+//                               more than MS milliseconds in total.
+//                      --forfeit With a budget, end a game as soon as the
+//                               agent overruns it, scoring it like a
+//                               death.
+//                      --seed S Seed for random worlds and the RandomAI.
+//                               Default: the current time. With -f, each
+//                               world's game is seeded by S and its file
+//                               name.
+//                      --result-cache PATH With -f, reuse the scores kept
+//                               in PATH and add new ones, so a rerun
+//                               only plays worlds or agents that changed
+//                               (see ResultCache.hpp). MyAI is only
+//                               cached when built with MYAI_BUILD_ID
+//                               (see MyAI.hpp).
+//                      --progress SECONDS With -f, report the games done,
+//                               the rate, the time left, the mean score
+//                               and the slowest world on standard error
+//                               every SECONDS seconds (see Progress.hpp).
+//                      --progress-file PATH With --progress, also write
+//                               each report to PATH.
+//                      --analytics PATH With -f, count per cell how often
+//                               agents enter it, die in it by pit or by
+//                               wumpus, bump a wall from it and waste
+//                               the arrow from it, and write the counts
+//                               to PATH (see Analytics.hpp).
+//
+//                  Merging shards:
+//
+//                  Wumpus_World merge StatisticsFile [StatisticsFile ...]
+//
+//                      Combines the statistics files of several shards
+//                      and prints the exact statistics of the whole suite
+//                      in the same format. Analytics files are merged the
+//                      same way.
+//
+//                  Generating suites:
+//
+//                  Wumpus_World generate Folder Count [Options]
+//
+//                      Writes Count distinct worlds to Folder; see
+//                      Generator.hpp for the options.
+//
+//                  Stress testing:
+//
+//                  Wumpus_World stress [Games] [Options]
+//
+//                      Plays Games random worlds on many threads at once
+//                      and checks every game against a single-threaded
+//                      run; see Stress.hpp for the options.
+//
+//                  Serving jobs:
+//
+//                  Wumpus_World serve SocketPath --suite NAME PATH [Options]
+//
+//                      Loads the suites once and runs jobs sent over a
+//                      Unix-domain socket; see Server.hpp for the options
+//                      and the protocol.
+//
+//                  Comparing agents:
+//
+//                  Wumpus_World compare AgentA AgentB Suite [Options]
+//
+//                      Plays both agents on the same games until the
+//                      difference between their scores is resolved; see
+//                      Compare.hpp for the options.
+//
+//                  Checking decisions:
+//
+//                  Wumpus_World fingerprint Agent Suite [Options]
+//
+//                      Records every action the agent takes on every
+//                      world and reports where it differs from a stored
+//                      baseline; see Fingerprint.hpp for the options.
+//
+//                  Measuring regret:
+//
+//                  Wumpus_World regret Agent Suite [Options]
+//
+//                      Solves every world with full knowledge of the
+//                      board and reports how far the agent's scores fall
+//                      short; see Solver.hpp for the options.
+//
+//                  Searching for failures:
+//
+//                  Wumpus_World search Agent Folder [Options]
+//
+//                      Edits boards towards ones the agent scores badly
+//                      or crashes on and saves them to Folder; see
+//                      Search.hpp for the options.
 //
 //                  InputFile: A path to a valid Wumpus World File, or
 //                             folder with -f. This is optional unless
@@ -42,21 +152,146 @@
  
 #include <iostream>
 #include <ctime>
-#include <dirent.h>
 #include <cmath>
+#include <algorithm>
+#include <cstdio>
 #include "World.hpp"
+#include "Hash.hpp"
+#include "Statistics.hpp"
+#include "Generator.hpp"
+#include "Evaluator.hpp"
+#include "Stress.hpp"
+#include "Server.hpp"
+#include "Compare.hpp"
+#include "Fingerprint.hpp"
+#include "Solver.hpp"
+#include "Search.hpp"
 
 using namespace std;
 
 int main ( int argc, char *argv[] )
 {
-	// Set random seed
-	srand( time ( NULL ) );
+	// Subcommands with their own options
+	if ( argc >= 2 && string ( argv[1] ) == "generate" )
+		return generateSuite ( argc - 2, argv + 2 );
+	if ( argc >= 2 && string ( argv[1] ) == "stress" )
+		return runStress ( argc - 2, argv + 2 );
+	if ( argc >= 2 && string ( argv[1] ) == "serve" )
+		return runServer ( argc - 2, argv + 2 );
+	if ( argc >= 2 && string ( argv[1] ) == "compare" )
+		return runCompare ( argc - 2, argv + 2 );
+	if ( argc >= 2 && string ( argv[1] ) == "fingerprint" )
+		return runFingerprint ( argc - 2, argv + 2 );
+	if ( argc >= 2 && string ( argv[1] ) == "regret" )
+		return runRegret ( argc - 2, argv + 2 );
+	if ( argc >= 2 && string ( argv[1] ) == "search" )
+		return runSearch ( argc - 2, argv + 2 );
+	
+	// Long options are pulled out of argv first, so the parsing below
+	// only ever sees the positional syntax
+	int		fps          = 0;
+	int		tailFrames   = 0;
+	int		shardIndex   = 0;
+	int		shardCount   = 0;		// 0 when not sharding
+	World::TimeBudget	budget;
+	bool	dedupe       = false;
+	uint64_t	seed     = time ( NULL );
+	string	resultCache  = "";
+	double	progress     = 0;
+	string	progressFile = "";
+	string	analytics    = "";
+	int		kept         = 1;
+	
+	for ( int index = 1; index < argc; ++index )
+	{
+		string token = argv[index];
+		
+		if ( token == "--fps" && index + 1 < argc )
+			fps = atoi ( argv[++index] );
+		else if ( token == "--tail" && index + 1 < argc )
+			tailFrames = max ( 0, atoi ( argv[++index] ) );
+		else if ( token == "--move-budget" && index + 1 < argc )
+			budget.perMove = chrono::microseconds ( atol ( argv[++index] ) );
+		else if ( token == "--game-budget" && index + 1 < argc )
+			budget.perGame = chrono::milliseconds ( atol ( argv[++index] ) );
+		else if ( token == "--forfeit" )
+			budget.forfeit = true;
+		else if ( token == "--dedupe" )
+			dedupe = true;
+		else if ( token == "--seed" && index + 1 < argc )
+			seed = strtoull ( argv[++index], NULL, 10 );
+		else if ( token == "--result-cache" && index + 1 < argc )
+			resultCache = argv[++index];
+		else if ( token == "--progress" && index + 1 < argc )
+			progress = max ( 0.0, atof ( argv[++index] ) );
+		else if ( token == "--progress-file" && index + 1 < argc )
+			progressFile = argv[++index];
+		else if ( token == "--analytics" && index + 1 < argc )
+			analytics = argv[++index];
+		else if ( token == "--shard" && index + 1 < argc )
+		{
+			if ( sscanf ( argv[++index], "%d/%d", &shardIndex, &shardCount ) != 2
+					|| shardCount <= 0 || shardIndex < 0 || shardIndex >= shardCount )
+			{
+				cout << "[ERROR] --shard expects I/N with 0 <= I < N." << endl;
+				return 0;
+			}
+		}
+		else
+			argv[kept++] = argv[index];
+	}
+	argc = kept;
+	
+	bool		timed = budget.perMove.count() > 0 || budget.perGame.count() > 0;
+	BudgetReport	budgetReport;
+	
+	FrameRenderer renderer ( fps, tailFrames );
+	
+	if ( argc >= 2 && string ( argv[1] ) == "merge" )
+	{
+		// Analytics files say so on their first line
+		ifstream	first ( argc >= 3 ? argv[2] : "" );
+		string		header;
+		first >> header;
+		
+		if ( header == "ANALYTICS" )
+		{
+			SpatialStats total;
+			for ( int index = 2; index < argc; ++index )
+			{
+				ifstream		file ( argv[index] );
+				SpatialStats	shard;
+				if ( !shard.read ( file ) )
+				{
+					cout << "[ERROR] Failed to read analytics file " << argv[index] << "." << endl;
+					return 0;
+				}
+				total.merge ( shard );
+			}
+			total.write ( cout );
+			return 0;
+		}
+		
+		RunningStats total;
+		for ( int index = 2; index < argc; ++index )
+		{
+			ifstream		file ( argv[index] );
+			RunningStats	shard;
+			if ( !shard.read ( file ) )
+			{
+				cout << "[ERROR] Failed to read statistics file " << argv[index] << "." << endl;
+				return 0;
+			}
+			total.merge ( shard );
+		}
+		total.write ( cout );
+		return 0;
+	}
 	
 	if ( argc == 1 )
 	{
 		// Run on a random world and exit
-		World world;
+		World world ( false, false, false, "", seed );
 		int score = world.run();
 		cout << "Your agent scored: " << score << endl;
 		return 0;
@@ -68,6 +303,7 @@ int main ( int argc, char *argv[] )
 	bool 	randomAI     = false;
 	bool 	manualAI      = false;
 	bool 	folder       = false;
+	bool	cache        = false;
 	string	worldFile    = "";
 	string	outputFile   = "";
 	string 	firstToken 	 = argv[1];
@@ -93,6 +329,11 @@ int main ( int argc, char *argv[] )
 					verbose = true;
 					break;
 					
+				case 'c':
+				case 'C':
+					cache = true;
+					break;
+					
 				case 'r':
 				case 'R':
 					randomAI = true;
@@ -126,6 +367,68 @@ int main ( int argc, char *argv[] )
 					cout << "\t   display the average score and standard" << endl;
 					cout << "\t   deviation instead of a single score. InputFile" << endl;
 					cout << "\t   must be entered with this option." << endl;
+					cout << "\t-c Prefix cache mode, which memoises MyAI's" << endl;
+					cout << "\t   decisions by percept history and replays them" << endl;
+					cout << "\t   across the worlds of a folder. Only useful" << endl;
+					cout << "\t   with -f." << endl;
+					cout << endl;
+					cout << "Long Options:" << endl;
+					cout << "\t--fps N  With -d, advance automatically at N frames" << endl;
+					cout << "\t         per second instead of waiting for ENTER." << endl;
+					cout << "\t--tail N With -d, keep only the last N frames of" << endl;
+					cout << "\t         each game and print them when it ends." << endl;
+					cout << "\t         Not allowed with -m." << endl;
+					cout << "\t--dedupe With -f, play each distinct board once" << endl;
+					cout << "\t         and weight its score by its copies." << endl;
+					cout << "\t--shard I/N With -f, run only the worlds whose file" << endl;
+					cout << "\t         name hashes to shard I of N and write" << endl;
+					cout << "\t         mergeable statistics." << endl;
+					cout << "\t--move-budget US Flag agent moves slower than US" << endl;
+					cout << "\t         microseconds." << endl;
+					cout << "\t--game-budget MS Flag games where the agent thinks" << endl;
+					cout << "\t         for more than MS milliseconds in total." << endl;
+					cout << "\t--forfeit End a game on its first budget overrun," << endl;
+					cout << "\t         scoring it like a death." << endl;
+					cout << "\t--seed S Seed for random worlds and the RandomAI." << endl;
+					cout << "\t--result-cache PATH With -f, reuse the scores kept" << endl;
+					cout << "\t         in PATH and play only the worlds missing." << endl;
+					cout << "\t--progress SECONDS With -f, report progress on" << endl;
+					cout << "\t         standard error every SECONDS seconds." << endl;
+					cout << "\t--progress-file PATH With --progress, also write" << endl;
+					cout << "\t         each report to PATH." << endl;
+					cout << "\t--analytics PATH With -f, write per-cell visit," << endl;
+					cout << "\t         death, bump and wasted-arrow counts to PATH." << endl;
+					cout << endl;
+					cout << "Wumpus_World merge StatisticsFile [StatisticsFile ...]" << endl;
+					cout << "\tCombines the statistics or analytics of several" << endl;
+					cout << "\tshards." << endl;
+					cout << endl;
+					cout << "Wumpus_World generate Folder Count [Options]" << endl;
+					cout << "\tWrites Count distinct worlds to Folder." << endl;
+					cout << endl;
+					cout << "Wumpus_World stress [Games] [Options]" << endl;
+					cout << "\tPlays games on many threads and checks they" << endl;
+					cout << "\tmatch a single-threaded run." << endl;
+					cout << endl;
+					cout << "Wumpus_World serve SocketPath --suite NAME PATH [Options]" << endl;
+					cout << "\tKeeps suites in memory and runs jobs sent over" << endl;
+					cout << "\ta Unix-domain socket." << endl;
+					cout << endl;
+					cout << "Wumpus_World compare AgentA AgentB Suite [Options]" << endl;
+					cout << "\tPlays both agents on the same games until one" << endl;
+					cout << "\tis shown to score higher." << endl;
+					cout << endl;
+					cout << "Wumpus_World fingerprint Agent Suite [Options]" << endl;
+					cout << "\tRecords the agent's actions on every world and" << endl;
+					cout << "\tdiffs them against a baseline." << endl;
+					cout << endl;
+					cout << "Wumpus_World regret Agent Suite [Options]" << endl;
+					cout << "\tCompares the agent's scores with the best" << endl;
+					cout << "\tpossible on every world." << endl;
+					cout << endl;
+					cout << "Wumpus_World search Agent Folder [Options]" << endl;
+					cout << "\tLooks for boards the agent fails on and saves" << endl;
+					cout << "\tthem as world files." << endl;
 					cout << endl;
 					cout << "InputFile: A path to a valid Wumpus World File, or" << endl;
 					cout << "           folder with -f. This is optional unless" << endl;
@@ -144,6 +447,13 @@ int main ( int argc, char *argv[] )
 			manualAI = false;
 			cout << "[WARNING] Manual AI and Random AI both on; Manual AI was turned off." << endl;
 		}
+
+		// The manual player has to see each board before choosing a move
+		if ( manualAI && tailFrames > 0 )
+		{
+			cout << "[ERROR] --tail cannot be used with -m." << endl;
+			return 0;
+		}
 		
 		if ( argc >= 3 )
 			worldFile = argv[2];
@@ -162,65 +472,68 @@ int main ( int argc, char *argv[] )
 	{
 		if ( folder )
 			cout << "[WARNING] No folder specified; running on a random world." << endl;
-		World world ( debug, randomAI, manualAI );
+		World world ( debug, randomAI, manualAI, "", seed );
+		world.setRenderer ( renderer );
+		world.setTimeBudget ( budget );
 		int score = world.run();
 		cout << "The agent scored: " << score << endl;
+		if ( timed )
+		{
+			budgetReport.add ( world, "random world" );
+			budgetReport.print ( cout );
+		}
 		return 0;
 	}
 	
 	if ( folder )
 	{
-		DIR *dir;
-		if ( ( dir = opendir (worldFile.c_str()) ) == NULL )
+		EvaluationOptions options;
+		options.debug      = debug;
+		options.verbose    = verbose;
+		options.randomAI   = randomAI;
+		options.manualAI   = manualAI;
+		options.cache      = cache;
+		options.dedupe     = dedupe;
+		options.shardIndex = shardIndex;
+		options.shardCount = shardCount;
+		options.renderer   = renderer;
+		options.budget     = budget;
+		options.seed       = seed;
+		options.resultCache = resultCache;
+		options.progress    = chrono::milliseconds ( (long) ( progress * 1000 ) );
+		options.progressFile = progressFile;
+		options.analytics    = analytics;
+		
+		Evaluator evaluator ( options );
+		if ( !evaluator.load ( worldFile ) )
 		{
 			cout << "[ERROR] Failed to open directory." << endl;
 			return 0;
 		}
+		evaluator.run();
 		
-		struct dirent *ent;
+		const RunningStats& stats = evaluator.getStats();
 		
-		int		numOfScores        = 0;
-		double	sumOfScores        = 0;
-		double	sumOfScoresSquared = 0;
+		if ( timed )
+			evaluator.getBudgetReport().print ( cout );
 		
-		while ( ( ent = readdir (dir) ) != NULL )
+        std::cout << "The sum of scores is : " << stats.sum() << std::endl;
+        std::cout << "The number of scores is: " << stats.count << std::endl;;
+		double avg = stats.mean;
+		double std_dev = stats.stdev();
+		
+		if ( shardCount > 0 )
 		{
-			if ( ent->d_name[0] == '.' )
-				continue;
-			
-			if ( verbose )
-				cout << "Running world: " << ent->d_name << endl;
-			
-			string individualWorldFile = worldFile + "/" + ent->d_name;
-			
-			int score;
-			try
-			{
-				World world ( debug, randomAI, manualAI, individualWorldFile );
-				score = world.run();
-			}
-			catch (...)
+			// Shards always emit the mergeable format
+			if ( outputFile == "" )
+				stats.write ( cout );
+			else
 			{
-                std::cout << "error caught, resetting scores" << std::endl;
-				numOfScores = 0;
-				sumOfScores = 0;
-				sumOfScoresSquared = 0;
-				break;
+				ofstream file ( outputFile );
+				stats.write ( file );
 			}
-
-			numOfScores += 1;
-			sumOfScores += score;
-			sumOfScoresSquared += score*score;
 		}
-		
-		closedir (dir);
-		
-        std::cout << "The sum of scores is : " << sumOfScores << std::endl;
-        std::cout << "The number of scores is: " << numOfScores << std::endl;;
-		double avg = (float)sumOfScores / (float)numOfScores;
-		double std_dev = sqrt ( (sumOfScoresSquared - ((sumOfScores*sumOfScores) / (float)numOfScores) ) / (float)numOfScores );
-		
-		if ( outputFile == "" )
+		else if ( outputFile == "" )
 		{
 			cout << "The agent's average score: " << avg << endl;
 			cout << "The agent's standard deviation: " << std_dev << endl;
@@ -242,8 +555,15 @@ int main ( int argc, char *argv[] )
 		if ( verbose )
 			cout << "Running world: " << worldFile << endl;
 		
-		World world ( debug, randomAI, manualAI, worldFile );
+		World world ( debug, randomAI, manualAI, worldFile, seed );
+		world.setRenderer ( renderer );
+		world.setTimeBudget ( budget );
 		int score = world.run();
+		if ( timed )
+		{
+			budgetReport.add ( world, worldFile );
+			budgetReport.print ( cout );
+		}
 		if ( outputFile == "" )
 		{
 			cout << "The agent scored: " << score << endl;
@@ -31,6 +31,10 @@ class ManualAI : public Agent
 {
 public:
 
+	// Prompts on 'out' and reads the moves from 'in'
+	explicit ManualAI ( std::istream& in = std::cin, std::ostream& out = std::cout )
+		: in ( &in ), out ( &out ) {}
+
 	Action getAction
 	(
 		bool stench,
@@ -41,14 +45,14 @@ public:
 	)
 	{
 		// Print Command Menu
-		std::cout << "Press 'w' to Move Forward  'a' to 'Turn Left' 'd' to 'Turn Right'" << std::endl;
-		std::cout << "Press 's' to Shoot         'g' to 'Grab'      'c' to 'Climb'" << std::endl;
+		*out << "Press 'w' to Move Forward  'a' to 'Turn Left' 'd' to 'Turn Right'" << std::endl;
+		*out << "Press 's' to Shoot         'g' to 'Grab'      'c' to 'Climb'" << std::endl;
 		
 		// Get Input
-		std::cout << "Please input: ";
+		*out << "Please input: ";
 		char userInput;
-		std::cin >> userInput;
-		std::cin.ignore(9999, '\n');
+		*in >> userInput;
+		in->ignore(9999, '\n');
 		
 		// Return Action Associated with Input
 		if ( userInput == 'w' )
@@ -68,6 +72,16 @@ public:
 
 		return CLIMB;
 	}
+	
+	Agent* clone ( void ) const
+	{
+		return new ManualAI ( *this );
+	}
+	
+private:
+
+	std::istream*	in;
+	std::ostream*	out;
 };
 
 #endif
\ No newline at end of file
@@ -19,13 +19,31 @@
 
 #include "MyAI.hpp"
 
+const MyAI::Rotation MyAI::rotationGrid[4][4] =
+{
+    {{0, Agent::Action::TURN_LEFT}, {2, Agent::Action::TURN_LEFT}, {1, Agent::Action::TURN_LEFT}, {1, Agent::Action::TURN_RIGHT}},
+    {{2, Agent::Action::TURN_LEFT}, {0, Agent::Action::TURN_LEFT}, {1, Agent::Action::TURN_RIGHT}, {1, Agent::Action::TURN_LEFT}},
+    {{1, Agent::Action::TURN_RIGHT}, {1, Agent::Action::TURN_LEFT}, {0, Agent::Action::TURN_LEFT}, {2, Agent::Action::TURN_LEFT}},
+    {{1, Agent::Action::TURN_LEFT}, {1, Agent::Action::TURN_RIGHT}, {2, Agent::Action::TURN_LEFT}, {0, Agent::Action::TURN_LEFT}},
+};
+
 MyAI::MyAI()
     : Agent()
 {
 }
+
+const char* MyAI::buildId() const
+{
+#ifdef MYAI_BUILD_ID
+    return "MyAI " MYAI_BUILD_ID;
+#else
+    return NULL;
+#endif
+}
 	
 Agent::Action MyAI::getAction (bool stench, bool breeze, bool glitter, bool bump, bool scream)
 {
+    PROFILE_TIMER(TIMER_GET_ACTION);
     if (bump)
     {
         updatePosition(true);
@@ -34,43 +52,43 @@ Agent::Action MyAI::getAction (bool stench, bool breeze, bool glitter, bool bump
     updateMap(stench, breeze);
     if (scream)
     {
-        wumpusAlive = false;
-        this->state = AgentState::Exploring;
+        memory.wumpusAlive = false;
+        this->memory.state = AgentState::Exploring;
     }
-    if (glitter && this->state != AgentState::Returning)
+    if (glitter && this->memory.state != AgentState::Returning)
     {
         clearActionQueue();
-        this->hasGold = true;
-        this->state = AgentState::Returning;
+        this->memory.hasGold = true;
+        this->memory.state = AgentState::Returning;
         return Agent::Action::GRAB;
     }
-    if (breeze && this->state != AgentState::Returning)
+    if (breeze && this->memory.state != AgentState::Returning)
     {
         clearActionQueue();
-        this->state = AgentState::Returning;
+        this->memory.state = AgentState::Returning;
     }
-    else if (stench && wumpusAlive && this->state != AgentState::Returning) 
+    else if (stench && memory.wumpusAlive && this->memory.state != AgentState::Returning) 
     {
-        if (this->hasArrow)
+        if (this->memory.hasArrow)
         {
-            hasArrow = false;
+            memory.hasArrow = false;
             return Agent::Action::SHOOT;
         }
-        this->state = AgentState::Returning;
+        this->memory.state = AgentState::Returning;
     }
-    if (this->state == AgentState::Returning && !hasGold && !breeze && (!stench || !wumpusAlive) && !possibleDirections().empty())
+    if (this->memory.state == AgentState::Returning && !memory.hasGold && !breeze && (!stench || !memory.wumpusAlive) && !possibleDirections().empty())
     {
-         this->state = AgentState::Exploring;
+         this->memory.state = AgentState::Exploring;
     }
-    if (actionQueue.empty())
+    if (memory.actionQueue.empty())
         takeAction();
     return returnAction();
 }
 
 Agent::Action MyAI::returnAction()
 {
-    Agent::Action action = actionQueue.front();
-    actionQueue.pop();
+    Agent::Action action = memory.actionQueue.front();
+    memory.actionQueue.pop();
     if (action == Agent::Action::FORWARD)
         updatePosition();
     else if (action == Agent::Action::TURN_LEFT || action == Agent::Action::TURN_RIGHT)
@@ -97,38 +115,25 @@ void MyAI::locateWumpus()
 
 void MyAI::updateDirection(Agent::Action action)
 {
-    switch (this->facing)
-    {
-        case Direction::Up:
-            (action == Agent::Action::TURN_LEFT) ? this->facing = Direction::Left : this->facing = Direction::Right;
-            break;
-        case Direction::Down:
-            (action == Agent::Action::TURN_LEFT) ? this->facing = Direction::Right : this->facing = Direction::Left;
-            break;
-        case Direction::Left:
-            (action == Agent::Action::TURN_LEFT) ? this->facing = Direction::Down : this->facing = Direction::Up;
-            break;
-        case Direction::Right:
-            (action == Agent::Action::TURN_LEFT) ? this->facing = Direction::Up : this->facing = Direction::Down;
-            break;
-    }
+    const int* turn = (action == Agent::Action::TURN_LEFT) ? Compass::AGENT_LEFT_OF : Compass::AGENT_RIGHT_OF;
+    this->memory.facing = static_cast<Direction>(turn[this->memory.facing]);
 }
 
 void MyAI::takeAction()
 {
-    std::vector<Direction> directions;
+    Directions directions;
 start:
-    switch (this->state)
+    switch (this->memory.state)
     {
         case AgentState::Exploring:
             directions = possibleDirections();
             if (directions.empty())
             {
-                this->state = AgentState::Returning;
+                this->memory.state = AgentState::Returning;
                 goto start;
             }
             for (auto direction : directions)
-                if (direction == this->facing)
+                if (direction == this->memory.facing)
                 {
                     move(direction);
                     return;
@@ -138,65 +143,62 @@ start:
         case AgentState::Hunting:
             break;
         case AgentState::Returning:
-            if (this->position == std::pair<int, int>{0, 0})
-                this->actionQueue.front() = Agent::Action::CLIMB;
+            if (this->memory.position == std::pair<int, int>{0, 0})
+                this->memory.actionQueue.push(Agent::Action::CLIMB);
             else
-                move(shortestPath());
+            {
+                // With no known way home, stay put and let the game run out rather than step somewhere unsafe
+                Direction direction;
+                if (shortestPath(direction))
+                    move(direction);
+                else
+                    this->memory.actionQueue.push(Agent::Action::CLIMB);
+            }
             break;
     }
 }
 
 void MyAI::updatePosition(bool hitWall)
 {
-    switch(this->facing)
-    {
-        case Direction::Up:
-            (hitWall) ? this->position.second -= 1 : this->position.second += 1;
-            break;
-        case Direction::Down:
-            (hitWall) ? this->position.second += 1 : this->position.second -= 1;
-            break;
-        case Direction::Left:
-            (hitWall) ? this->position.first += 1 : this->position.first -= 1;
-            break;
-        case Direction::Right:
-            (hitWall) ? this->position.first -= 1 : this->position.first += 1;
-            break;
-    }
+    // A bump undoes the step logged when FORWARD was returned
+    this->memory.moveLog.append(hitWall ? MoveLog::opposite(this->memory.facing) : this->memory.facing);
+    int step = hitWall ? -1 : 1;
+    this->memory.position.first += step * Compass::AGENT_DX[this->memory.facing];
+    this->memory.position.second += step * Compass::AGENT_DY[this->memory.facing];
 }
 
 void MyAI::markWalls()
 {
     for (int i = 0; i < 7; ++i)
     {
-        if (this->facing == Direction::Up)
-            mapAt(std::pair<int, int>(i, this->position.second + 1)).wall = true;
-        else if (this->facing == Direction::Right)
-            mapAt(std::pair<int, int>(this->position.first + 1, i)).wall = true;
+        if (this->memory.facing == Direction::Up)
+            mapAt(std::pair<int, int>(i, this->memory.position.second + 1)).wall = true;
+        else if (this->memory.facing == Direction::Right)
+            mapAt(std::pair<int, int>(this->memory.position.first + 1, i)).wall = true;
     }
 }
 
 void MyAI::updateMap(bool stench, bool breeze)
 {
-    mapAt(this->position) = {true, false, breeze, stench, false};
+    mapAt(this->memory.position) = {true, false, breeze, stench, false};
 }
 
 MyAI::Tile& MyAI::mapAt(std::pair<int, int> coordinate)
 {
-    return map[6 - coordinate.second][coordinate.first];
+    return memory.map[6 - coordinate.second][coordinate.first];
 }
 
 void MyAI::move(MyAI::Direction direction)
 {
-    std::vector<Agent::Action> actions = this->rotationGrid[this->facing][direction];
-    for (auto it = actions.begin(); it != actions.end(); ++it)
-        this->actionQueue.push(*it);
-    this->actionQueue.push(Agent::Action::FORWARD);
+    const Rotation& rotation = this->rotationGrid[this->memory.facing][direction];
+    for (int i = 0; i < rotation.size; ++i)
+        this->memory.actionQueue.push(rotation.action);
+    this->memory.actionQueue.push(Agent::Action::FORWARD);
 }
 
 MyAI::Direction MyAI::relationalDirection(std::pair<int, int> targetTile)
 {
-    std::pair<int, int> relation = std::pair<int, int>{this->position.first - targetTile.first, this->position.second - targetTile.second};
+    std::pair<int, int> relation = std::pair<int, int>{this->memory.position.first - targetTile.first, this->memory.position.second - targetTile.second};
     if(relation == std::make_pair(0, 1))
         return Direction::Down;
     else if(relation == std::make_pair(0, -1))
@@ -211,6 +213,7 @@ MyAI::Direction MyAI::relationalDirection(std::pair<int, int> targetTile)
 
 bool MyAI::inferSafeTile(std::pair<int,int> coordinate)
 {
+    PROFILE_COUNT(MYAI_INFER_SAFE_TILE);
     auto up = std::make_pair(coordinate.first, coordinate.second + 1);
     auto down = std::make_pair(coordinate.first, coordinate.second - 1);
     auto left = std::make_pair(coordinate.first - 1, coordinate.second);
@@ -221,7 +224,7 @@ bool MyAI::inferSafeTile(std::pair<int,int> coordinate)
         auto downTile = mapAt(down);
         if (upTile.visited && downTile.visited)
             if (!(upTile.breeze && downTile.breeze))
-                if (!wumpusAlive || !(upTile.stench && downTile.stench))
+                if (!memory.wumpusAlive || !(upTile.stench && downTile.stench))
                     return true;
     }
     if (inBounds(left) && inBounds(right))
@@ -230,7 +233,7 @@ bool MyAI::inferSafeTile(std::pair<int,int> coordinate)
         auto rightTile = mapAt(right);
         if (leftTile.visited && rightTile.visited)
             if (!(leftTile.breeze && rightTile.breeze))
-                if (!wumpusAlive || !(leftTile.stench && rightTile.stench))
+                if (!memory.wumpusAlive || !(leftTile.stench && rightTile.stench))
                     return true;
     }
     return false;
@@ -269,89 +272,118 @@ bool MyAI::validReturnCell(std::pair<int, int> coordinate)
 
 std::pair<int, int> MyAI::applyDirection(std::pair<int, int> current, Direction d)
 {
-    switch (d)
-    {
-        case Direction::Up:
-            return std::make_pair(current.first, current.second + 1);
-        case Direction::Down:
-            return std::make_pair(current.first, current.second - 1);
-        case Direction::Left:
-            return std::make_pair(current.first - 1, current.second);
-        case Direction::Right:
-            return std::make_pair(current.first + 1, current.second);
-    }
+    return std::make_pair(current.first + Compass::AGENT_DX[d], current.second + Compass::AGENT_DY[d]);
 }
 
-std::vector<MyAI::Direction> MyAI::validMoves(std::pair<int, int> currentTile, const std::unordered_set<std::pair<int, int>>& pathTraveled)
+bool MyAI::shortestPath(Direction& direction)
 {
-    std::vector<MyAI::Direction> directions;
-    if (pathTraveled.find(applyDirection(currentTile, Direction::Up)) == pathTraveled.end() && validReturnCell(applyDirection(currentTile, Direction::Up)))
-        directions.push_back(Direction::Up);
-    if (pathTraveled.find(applyDirection(currentTile, Direction::Down)) == pathTraveled.end() && validReturnCell(applyDirection(currentTile, Direction::Down)))
-        directions.push_back(Direction::Down);
-    if (pathTraveled.find(applyDirection(currentTile, Direction::Left)) == pathTraveled.end() && validReturnCell(applyDirection(currentTile, Direction::Left)))
-        directions.push_back(Direction::Left);
-    if (pathTraveled.find(applyDirection(currentTile, Direction::Right)) == pathTraveled.end() && validReturnCell(applyDirection(currentTile, Direction::Right)))
-        directions.push_back(Direction::Right);
-    return directions;
-}
+    PROFILE_TIMER(TIMER_SHORTEST_PATH);
+    uint64_t cells = returnCells();
+    if (cells != this->memory.home.cells)
+        buildHomeField(cells);
 
-int MyAI::pathCost(std::unordered_set<std::pair<int, int>>& pathTraveled, std::pair<int, int> currentTile, Direction currentFacing)
-{
-    if (currentTile == std::make_pair(0, 0))
-        return 0;
-    else
+    const HomeField& home = this->memory.home;
+    Direction result = this->memory.facing;
+    int cheapest = std::numeric_limits<int>::max();
+    for (int d = Direction::Up; d <= Direction::Right; ++d)
     {
-        pathTraveled.insert(currentTile);
-        std::vector<Direction> moves = validMoves(currentTile, pathTraveled);
-        if (moves.empty())
+        std::pair<int, int> next = applyDirection(this->memory.position, static_cast<Direction>(d));
+        if (!inBounds(next) || !(cells >> (next.first * 7 + next.second) & 1))
+            continue;
+        unsigned short rest = home.cost[next.first][next.second][d];
+        if (rest == HomeField::UNREACHABLE)
+            continue;
+        int cost = rotationGrid[this->memory.facing][d].size + 1 + rest;
+        if (cost < cheapest)
         {
-            pathTraveled.erase(currentTile);
-            return 100000;
+            cheapest = cost;
+            result = static_cast<Direction>(d);
         }
-        std::vector<int> costs;
-        for (auto move : moves)
-            costs.push_back(rotationGrid[currentFacing][move].size() + 1 + pathCost(pathTraveled, applyDirection(currentTile, move), move));
-        pathTraveled.erase(currentTile);
-        return *(std::min_element(costs.begin(), costs.end()));
     }
+    if (cheapest != std::numeric_limits<int>::max())
+    {
+        direction = result;
+        return true;
+    }
+    if (this->memory.moveLog.usable())
+    {
+        direction = this->memory.moveLog.backtrack();
+        return true;
+    }
+    return false;
 }
 
-MyAI::Direction MyAI::shortestPath()
+uint64_t MyAI::returnCells()
 {
-    Direction result;
-    int cheapest = std::numeric_limits<int>::max();
-    std::unordered_set<std::pair<int, int>> pathTraveled;
-    std::vector<Direction> moves = validMoves(this->position, pathTraveled);
-    pathTraveled.insert(position);
-    for (auto d : moves)
+    uint64_t cells = 0;
+    for (int x = 0; x < 7; ++x)
+        for (int y = 0; y < 7; ++y)
+            if (validReturnCell(std::make_pair(x, y)))
+                cells |= uint64_t(1) << (x * 7 + y);
+    return cells;
+}
+
+void MyAI::buildHomeField(uint64_t cells)
+{
+    HomeField& home = this->memory.home;
+    home.cells = cells;
+
+    bool settled[7][7][4] = {};
+    for (int x = 0; x < 7; ++x)
+        for (int y = 0; y < 7; ++y)
+            for (int f = 0; f < 4; ++f)
+                home.cost[x][y][f] = (x == 0 && y == 0) ? 0 : HomeField::UNREACHABLE;
+
+    for (;;)
     {
-        int pathcost = pathCost(pathTraveled, applyDirection(this->position, d), d) + rotationGrid[this->facing][d].size() + 1;
-        if (pathcost < cheapest)
+        // Settle the cheapest unsettled state; the graph is tiny, so a linear scan beats a heap
+        int x = -1, y = -1, f = -1;
+        unsigned short best = HomeField::UNREACHABLE;
+        for (int i = 0; i < 7; ++i)
+            for (int j = 0; j < 7; ++j)
+                for (int k = 0; k < 4; ++k)
+                    if (!settled[i][j][k] && home.cost[i][j][k] < best)
+                    {
+                        best = home.cost[i][j][k];
+                        x = i, y = j, f = k;
+                    }
+        if (best == HomeField::UNREACHABLE)
+            break;
+        settled[x][y][f] = true;
+
+        // Routes only pass through valid return cells; the agent's own cell need not be one
+        if (!(cells >> (x * 7 + y) & 1))
+            continue;
+
+        // Arriving at <x, y> facing f means stepping forward from the cell behind, after turning from any facing g
+        int px = x - Compass::AGENT_DX[f];
+        int py = y - Compass::AGENT_DY[f];
+        if (!inBounds(std::make_pair(px, py)))
+            continue;
+        for (int g = 0; g < 4; ++g)
         {
-            cheapest = pathcost;
-            result = d;
+            int cost = rotationGrid[g][f].size + 1 + best;
+            if (cost < home.cost[px][py][g])
+                home.cost[px][py][g] = cost;
         }
     }
-    return result;
 }
 
-std::vector<MyAI::Direction> MyAI::possibleDirections()
+MyAI::Directions MyAI::possibleDirections()
 {
-    std::vector<MyAI::Direction> directions;
-    if (validCell(std::make_pair(position.first + 1, position.second)))
+    Directions directions;
+    if (validCell(std::make_pair(memory.position.first + 1, memory.position.second)))
         directions.push_back(Direction::Right);
-    if (validCell(std::make_pair(position.first, position.second + 1)))
+    if (validCell(std::make_pair(memory.position.first, memory.position.second + 1)))
         directions.push_back(Direction::Up);
-    if (validCell(std::make_pair(position.first - 1, position.second)))
+    if (validCell(std::make_pair(memory.position.first - 1, memory.position.second)))
         directions.push_back(Direction::Left);
-    if (validCell(std::make_pair(position.first, position.second - 1)))
+    if (validCell(std::make_pair(memory.position.first, memory.position.second - 1)))
         directions.push_back(Direction::Down);
     return directions;
 }
 
 void MyAI::clearActionQueue()
 {
-    while (!actionQueue.empty())
-        actionQueue.pop();
+    memory.actionQueue.clear();
 }
@@ -21,8 +21,9 @@
 #define MYAI_LOCK
 
 #include "Agent.hpp"
-#include <queue>
-#include <stack>
+#include "Profiler.hpp"
+#include "Compass.hpp"
+#include <cstdint>
 #include <limits>
 #include <vector>
 #include <unordered_set>
@@ -52,29 +53,11 @@ public:
     // wumpus at the tile.
     struct Tile
     {
-        Tile ()
-        {
-            bool visited = false;
-            bool wumpus = false;
-            bool breeze = false;
-            bool stench = false;
-            bool wall = false;
-        }
-
-        Tile (bool v, bool w, bool b, bool s, bool wl)
-        {
-            visited = v;
-            wumpus = w;
-            breeze = b;
-            stench = s;
-            wall = wl;
-        }
-
-        bool visited;
-        bool wumpus;
-        bool breeze;
-        bool stench;
-        bool wall;
+        bool visited = false;
+        bool wumpus = false;
+        bool breeze = false;
+        bool stench = false;
+        bool wall = false;
     };
 
     // Direction represents the direction that the agent is facing.
@@ -86,6 +69,11 @@ public:
         Right
     };
 
+    // The AGENT_ tables in Compass.hpp are indexed by Direction
+    static_assert(Compass::FROM_AGENT[Up] == Compass::UP && Compass::FROM_AGENT[Down] == Compass::DOWN
+                  && Compass::FROM_AGENT[Left] == Compass::LEFT && Compass::FROM_AGENT[Right] == Compass::RIGHT,
+                  "Direction must follow Compass::FROM_AGENT");
+
     // AgentState represents which state or mode the agent is in. Different states require different actions
     // to be made by the AI.
     enum AgentState
@@ -97,16 +85,169 @@ public:
 
     class NonAdjacentTileException{};
 
+    // Rotation describes the turns needed to face one direction from another: 'size' repetitions of 'action'.
+    struct Rotation
+    {
+        unsigned char size;
+        Agent::Action action;
+    };
+
+    // Directions is a list of up to four directions with fixed storage, so listing the moves out of a cell
+    // never allocates.
+    struct Directions
+    {
+        Direction items[4];
+        unsigned char count = 0;
+
+        bool empty() const { return count == 0; }
+        void push_back(Direction d) { items[count++] = d; }
+        Direction operator[](int i) const { return items[i]; }
+        const Direction* begin() const { return items; }
+        const Direction* end() const { return items + count; }
+    };
+
+    // ActionQueue is a fixed-capacity ring buffer of pending actions. A single move never queues more than
+    // three actions, so the capacity is never reached in practice.
+    struct ActionQueue
+    {
+        static const int CAPACITY = 16;
+
+        Agent::Action actions[CAPACITY];
+        unsigned char head = 0;
+        unsigned char count = 0;
+
+        bool empty() const { return count == 0; }
+        Agent::Action front() const { return actions[head]; }
+        void push(Agent::Action action) { PROFILE_COUNT(MYAI_QUEUE_PUSH); actions[(head + count++) % CAPACITY] = action; }
+        void pop() { PROFILE_COUNT(MYAI_QUEUE_POP); head = (head + 1) % CAPACITY; --count; }
+        void clear() { PROFILE_COUNT(MYAI_QUEUE_CLEAR); head = 0; count = 0; }
+    };
+
+    // MoveLog records the agent's route from the entrance as runs of forward moves in one direction. A move
+    // opposite to the last run cancels one step of it instead of being recorded, so walking back over the route
+    // shrinks the log; both operations are O(1). Reading the runs backwards retraces the route to <0, 0>.
+    // If the route ever needs more than CAPACITY runs the log gives up and reports itself unusable.
+    struct MoveLog
+    {
+        static const int CAPACITY = 64;
+
+        struct Run
+        {
+            Direction direction;
+            unsigned char length;
+        };
+
+        Run runs[CAPACITY];
+        unsigned char count = 0;
+        bool overflowed = false;
+
+        // opposite() relies on the Direction enum pairing Up/Down and Left/Right
+        static Direction opposite(Direction d) { return static_cast<Direction>(d ^ 1); }
+
+        bool usable() const { return count > 0 && !overflowed; }
+
+        // backtrack() is the direction that retraces the last logged step.
+        Direction backtrack() const { return opposite(runs[count - 1].direction); }
+
+        void append(Direction d)
+        {
+            if (count > 0 && runs[count - 1].direction == opposite(d))
+            {
+                if (--runs[count - 1].length == 0)
+                    --count;
+            }
+            else if (count > 0 && runs[count - 1].direction == d && runs[count - 1].length < 255)
+                ++runs[count - 1].length;
+            else if (count < CAPACITY)
+                runs[count++] = {d, 1};
+            else
+                overflowed = true;
+        }
+    };
+
+    // HomeField caches the cost of the cheapest route home from every cell and facing, over the valid return
+    // cells it was built for. Costs count each turn and forward move as one action. It is rebuilt only when the
+    // set of valid return cells changes, so on the way home each step is a lookup of four neighbours.
+    struct HomeField
+    {
+        static const unsigned short UNREACHABLE = 0xFFFF;
+
+        // cells has bit x * 7 + y set for every valid return cell <x, y>; all bits set means never built.
+        uint64_t cells = ~uint64_t(0);
+
+        // cost is indexed [x][y][facing].
+        unsigned short cost[7][7][4];
+    };
+
+    // State is the agent's entire memory. It owns no heap storage, so copying it is a snapshot.
+    struct State
+    {
+        // actionQueue provides a method for complex actions to be strung together by the AI and executed
+        // in sequence without interruption
+        ActionQueue actionQueue;
+
+        // position keeps track of the agent's current position in the cave.
+        // It is in the form <x , y> with x referring to horizontal movement and y referring to
+        // vertical movement. The agent will always start at <0, 0>. Moving the agent right
+        // will result in x coordinate increasing; moving the agent up will result in the
+        // y coordinate increasing.
+        std::pair<int, int> position = std::pair<int, int>(0, 0);
+
+        // facing describes which direction the agent is currently facing.
+        Direction facing = Direction::Right;
+
+        // state is the current state of the Agent. The options are Exploring, Hunting, and Returning.
+        // Exploring state is the default state of the AI agent, in which the AI will choose a random direction to move.
+        // Hunting state is activated the first time the agent perceives a stench, and ends after finding a second stench.
+        // Returning state is activated when either the gold is recovered or a breeze is perceived, and the agent will return home immediately.
+        AgentState state = AgentState::Exploring;
+
+        MyAI::Tile map[7][7];
+
+        // moveLog is the route the agent took from the entrance; see MoveLog.
+        MoveLog moveLog;
+
+        // home is the route planner's cache; see HomeField.
+        HomeField home;
+
+        bool hasArrow = true;
+
+        bool hasGold = false;
+
+        bool wumpusAlive = true;
+    };
+
 	MyAI(void);
 	
 	Action getAction(bool stench, bool breeze, bool glitter, bool bump, bool scream);
 
+    Agent* clone() const { return new MyAI(*this); }
+
+    // reset() forgets the current game. The memory is a flat struct, so this reuses it in place.
+    void reset(uint64_t /*seed*/) { memory = State(); }
+
+    // MyAI is deterministic, but it always starts facing right and explores right before up, so a mirrored
+    // board is a different game for it.
+    bool isDeterministic() const { return true; }
+
+    // buildId() is MYAI_BUILD_ID, which the build should derive from the agent's sources, e.g.
+    //     -DMYAI_BUILD_ID="\"$(cat MyAI.hpp MyAI.cpp | sha1sum | cut -c1-16)\""
+    // so that an edit invalidates the cached results and a rebuild does not. Without it buildId() is NULL and
+    // MyAI's scores are never cached.
+    const char* buildId() const;
+
+    // snapshot() exposes the agent's memory so it can be copied out; restore() overwrites the memory with a
+    // previously taken snapshot. Because the agent is deterministic, restoring a snapshot taken after some
+    // sequence of percepts resumes play exactly as if that sequence had been replayed.
+    const State& snapshot() const { return memory; }
+    void restore(const State& snapshot) { memory = snapshot; }
+
 private:
     // move() pushes the required Agent::Actions to move in the given direction onto the actionQueue
     void move(Direction direction);
 
     // possibleDirections() returns a list of possible directions
-    std::vector<Direction> possibleDirections();
+    Directions possibleDirections();
 
 
     // markWalls() is called when the agent perceives a bump and marks either the top
@@ -117,23 +258,24 @@ private:
     // to the current tile.
     std::pair<int, int> applyDirection(std::pair<int, int> current, Direction d);
 
-    // validMoves() is a helper function that enumerates the directions the Agent could take at a tile along the current return
-    // path traveled. validMoves() will never allow the agent to move in the direction of a tile it has already visited along the
-    // current path.
-    std::vector<Direction> validMoves(std::pair<int, int> currentTile, const std::unordered_set<std::pair<int, int>>& pathTraveled);
-
     // validReturnCell() checks if the tile at the coordinate is considered a valid cell to travel on for the return path.
     // A cell is a valid return cell if:
     // 1) it has been visited before, OR
     // 2) we can infer the tile's safety
     bool validReturnCell(std::pair<int, int> coordinate);
 
-    // pathCost() performs a depth first search on the map to determine the total cost of a path. It returns the cost of the
-    // cheapest path.
-    int pathCost(std::unordered_set<std::pair<int, int>>& pathTraveled, std::pair<int, int> currentTile, Direction currentFacing);
-
     // shortestPath() returns the direction the Agent should travel in order to reach the exit taking the shortest path.
-    MyAI::Direction shortestPath();
+    // It reads the answer from the home field, rebuilding the field first if the valid return cells have changed.
+    // Ties go to the first of Up, Down, Left, Right. If there is no route home, it falls back to retracing the
+    // agent's steps from the move log. It returns false, leaving direction alone, when neither finds a way.
+    bool shortestPath(Direction& direction);
+
+    // returnCells() returns the set of valid return cells as a HomeField::cells mask.
+    uint64_t returnCells();
+
+    // buildHomeField() recomputes memory.home for the given valid return cells with a Dijkstra search backwards
+    // from <0, 0> over (cell, facing) states.
+    void buildHomeField(uint64_t cells);
 
     // inferSafeTile() attempts to infer whether or not a tile is safe to travel on despite having never visited it before.
     // This is useful in the shortest path first function to take shortcuts home.
@@ -204,52 +346,15 @@ private:
     // when the agent enters 'Returning' state.
     void clearActionQueue();
 
-    // actionQueue provides a method for complex actions to be strung together by the AI and executed
-    // in sequence without interruption
-    std::queue<Agent::Action> actionQueue;
-
-    // previousPosition is a stack of std::pair<int, int> coordinates in the form <x , y> where each
-    // coordinate represents a tile that the agent has been. The agent starts at tile <0, 0> so previousPosition
-    // is initialized with <0, 0> on the top of the stack. When the agent returns an Action::FORWARD, the coordinate
-    // for the new room the agent will enter is pushed onto the stack. In the event of the agent hitting a wall,
-    // the top of stack will be popped as the agent was unable to move rooms.
-    std::stack<std::pair<int, int>> previousPosition;
-
-    // position keeps track of the agent's current position in the cave.
-    // It is in the form <x , y> with x referring to horizontal movement and y referring to
-    // vertical movement. The agent will always start at <0, 0>. Moving the agent right
-    // will result in x coordinate increasing; moving the agent up will result in the
-    // y coordinate increasing.
-    std::pair<int, int> position = std::pair<int, int>(0, 0);
-
-    // facing describes which direction the agent is currently facing.
-    Direction facing = Direction::Right;
-
-    // state is the current state of the Agent. The options are Exploring, Hunting, and Returning.
-    // Exploring state is the default state of the AI agent, in which the AI will choose a random direction to move.
-    // Hunting state is activated the first time the agent perceives a stench, and ends after finding a second stench.
-    // Returning state is activated when either the gold is recovered or a breeze is perceived, and the agent will return home immediately.
-    AgentState state = AgentState::Exploring;
-
-    MyAI::Tile map[7][7];
-
-    bool hasArrow = true;
-
-    bool hasGold = false;
-
-    bool wumpusAlive = true;
+    // memory holds everything the agent remembers between turns. Keeping it in a single flat struct lets
+    // the engine snapshot and restore the agent with a plain copy.
+    State memory;
 
     // rotationGrid provides a static lookup table to determine the proper number of rotations required to
     // face a particular direction from the current direction.
     // Accessing the array should be done in the format [currentDirection][desiredDirection] and can be
     // done using the Direction enum implementation.
-    const std::vector<Agent::Action> rotationGrid[4][4] = 
-    {
-    {{}, {Agent::Action::TURN_LEFT, Agent::Action::TURN_LEFT}, {Agent::Action::TURN_LEFT}, {Agent::Action::TURN_RIGHT}},
-    {{Agent::Action::TURN_LEFT, Agent::Action::TURN_LEFT}, {}, {Agent::Action::TURN_RIGHT}, {Agent::Action::TURN_LEFT}},
-    {{Agent::Action::TURN_RIGHT}, {Agent::Action::TURN_LEFT}, {}, {Agent::Action::TURN_LEFT, Agent::Action::TURN_LEFT}},
-    {{Agent::Action::TURN_LEFT}, {Agent::Action::TURN_RIGHT}, {Agent::Action::TURN_LEFT, Agent::Action::TURN_LEFT}, {}},
-    };
+    static const Rotation rotationGrid[4][4];
 };
 
 #endif
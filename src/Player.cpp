@@ -0,0 +1,24 @@
+// ======================================================================
+// FILE:        Player.cpp
+//
+// DESCRIPTION: This file contains Player, which plays one game after
+//              another with the same agent.
+// ======================================================================
+
+#include "Player.hpp"
+#include "FixedWorld.hpp"
+
+int Player::play ( const WorldDescription& description, uint64_t seed )
+{
+	int score;
+
+	agent->reset ( World::agentSeed ( seed ) );
+	if ( playFixed ( description, *agent, score, analytics ) )
+		return score;
+
+	if ( !world )
+		world.reset ( new World ( description, agent->clone() ) );
+	world->reset ( description, seed );
+	world->setAnalytics ( analytics );
+	return world->run();
+}
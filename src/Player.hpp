@@ -0,0 +1,47 @@
+// ======================================================================
+// FILE:        Player.hpp
+//
+// DESCRIPTION: This file contains Player, which plays one game after
+//              another with the same agent. The agent, and the World
+//              used for boards no FixedWorld covers, are kept between
+//              games and reset rather than rebuilt.
+//
+// NOTES:       - A game with seed S plays exactly like a World built
+//                with seed S, and like -f --seed when S is the seed the
+//                Evaluator derives for the world.
+//
+//              - A Player is not thread-safe; give each thread its own,
+//                and its own SpatialStats if it records analytics.
+// ======================================================================
+
+#ifndef PLAYER_LOCK
+#define PLAYER_LOCK
+
+#include <cstdint>
+#include <memory>
+#include "Agent.hpp"
+#include "Analytics.hpp"
+#include "World.hpp"
+#include "WorldDescription.hpp"
+
+class Player
+{
+public:
+
+	// Takes ownership of the heap-allocated agent
+	explicit Player ( Agent* agent ) : agent ( agent ) {}
+
+	// Plays the world from the start and returns the score. Exceptions
+	// from the agent or an invalid world propagate.
+	int		play	( const WorldDescription& description, uint64_t seed );
+
+	// Records every game played from now on into 'stats'; NULL to stop
+	void	setAnalytics	( SpatialStats* stats ) { analytics = stats; }
+
+private:
+	std::unique_ptr<Agent>	agent;
+	SpatialStats*			analytics = NULL;
+	std::unique_ptr<World>	world;		// Built with a clone of 'agent' the first time it is needed
+};
+
+#endif /* PLAYER_LOCK */
@@ -0,0 +1,88 @@
+// ======================================================================
+// FILE:        PrefixCache.hpp
+//
+// DESCRIPTION: This file contains the prefix cache, which memoises the
+//              decisions of a deterministic agent across worlds. MyAI's
+//              action depends only on the percepts it has received so
+//              far, so two worlds that produce the same percept history
+//              also produce the same actions. The cache maps a hash of
+//              every percept history it has seen to the action the
+//              agent chose and a snapshot of the agent's memory right
+//              after choosing it.
+//
+// NOTES:       - The World replays cached actions for as long as the
+//                percept history matches a known prefix. On the first
+//                miss, it restores the agent from the last snapshot and
+//                lets the agent play from there, recording new entries
+//                as it goes.
+//
+//              - Only MyAI is cached; RandomAI and ManualAI are not
+//                deterministic.
+//
+//              - Every entry holds a full MyAI::State, over a kilobyte, so
+//                the cache stops growing at maxEntries. The default of
+//                1 << 16 entries keeps it under about 100 MB.
+// ======================================================================
+
+#ifndef PREFIXCACHE_LOCK
+#define PREFIXCACHE_LOCK
+
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include "Agent.hpp"
+#include "Hash.hpp"
+#include "MyAI.hpp"
+
+class PrefixCache
+{
+public:
+
+	struct Entry
+	{
+		Agent::Action	action;		// The action the agent returned for this history
+		MyAI::State		state;		// The agent's memory after returning it
+	};
+
+	// Hash of the empty percept history
+	static const uint64_t EMPTY_HISTORY = Hash::FNV_OFFSET;
+
+	PrefixCache ( size_t _maxEntries = 1 << 16 ) : maxEntries ( _maxEntries ) {}
+
+	// Extends a history hash by one turn of percepts (FNV-1a over a percept byte)
+	static uint64_t extend ( uint64_t history, bool stench, bool breeze, bool glitter, bool bump, bool scream )
+	{
+		unsigned char percepts = stench | breeze << 1 | glitter << 2 | bump << 3 | scream << 4;
+		return Hash::fnv1a ( history, percepts );
+	}
+
+	// Returns the entry for a history, or NULL if it has not been seen
+	const Entry* find ( uint64_t history )
+	{
+		++lookups;
+		auto it = entries.find ( history );
+		if ( it == entries.end() )
+			return NULL;
+		++hits;
+		return &it->second;
+	}
+
+	// Records a new history; silently ignored once the cache is full
+	void insert ( uint64_t history, Agent::Action action, const MyAI::State& state )
+	{
+		if ( entries.size() < maxEntries )
+			entries.emplace ( history, Entry { action, state } );
+	}
+
+	size_t	size	( void ) const { return entries.size(); }
+	size_t	getHits	( void ) const { return hits; }
+	size_t	getLookups ( void ) const { return lookups; }
+
+private:
+	std::unordered_map<uint64_t, Entry>	entries;	// Node based, so Entry pointers stay valid across inserts
+	size_t	maxEntries;
+	size_t	hits    = 0;
+	size_t	lookups = 0;
+};
+
+#endif /* PREFIXCACHE_LOCK */
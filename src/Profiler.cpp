@@ -0,0 +1,115 @@
+// ======================================================================
+// FILE:        Profiler.cpp
+//
+// DESCRIPTION: This file contains the per-thread bookkeeping behind the
+//              instrumentation macros in Profiler.hpp.
+// ======================================================================
+
+#include "Profiler.hpp"
+
+#include <iomanip>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+namespace Profiler
+{
+	static const char* counterNames[NUM_COUNTERS] =
+	{
+		"world.turn_left",
+		"world.turn_right",
+		"world.forward",
+		"world.shoot",
+		"world.grab",
+		"world.climb",
+		"myai.infer_safe_tile",
+		"myai.queue_push",
+		"myai.queue_pop",
+		"myai.queue_clear"
+	};
+
+	static const char* timerNames[NUM_TIMERS] =
+	{
+		"world.run",
+		"myai.get_action",
+		"myai.shortest_path"
+	};
+
+	// Registry of live thread blocks, plus the sum of blocks whose
+	// threads have exited
+	static mutex			registryLock;
+	static vector<Stats*>	liveStats;
+	static Stats			retiredStats;
+
+	struct Registration
+	{
+		Stats stats;
+
+		Registration()
+		{
+			lock_guard<mutex> guard ( registryLock );
+			liveStats.push_back ( &stats );
+		}
+
+		~Registration()
+		{
+			lock_guard<mutex> guard ( registryLock );
+			retiredStats.merge ( stats );
+			liveStats.erase ( find ( liveStats.begin(), liveStats.end(), &stats ) );
+		}
+	};
+
+	void Stats::merge ( const Stats& other )
+	{
+		for ( int i = 0; i < NUM_COUNTERS; ++i )
+			counters[i] += other.counters[i];
+
+		for ( int i = 0; i < NUM_TIMERS; ++i )
+		{
+			timerCalls[i] += other.timerCalls[i];
+			timerNanos[i] += other.timerNanos[i];
+		}
+	}
+
+	Stats& local ( void )
+	{
+		thread_local Registration registration;
+		return registration.stats;
+	}
+
+	Stats collect ( void )
+	{
+		lock_guard<mutex> guard ( registryLock );
+
+		Stats total = retiredStats;
+		for ( Stats* stats : liveStats )
+			total.merge ( *stats );
+		return total;
+	}
+
+	void printSummary ( ostream& out )
+	{
+		Stats total = collect();
+		ios::fmtflags	flags     = out.flags();
+		streamsize		precision = out.precision();
+
+		out << "---- Profile ----" << '\n';
+		for ( int i = 0; i < NUM_COUNTERS; ++i )
+			out << left << setw(24) << counterNames[i] << right << setw(14) << total.counters[i] << '\n';
+
+		for ( int i = 0; i < NUM_TIMERS; ++i )
+		{
+			double totalMs = total.timerNanos[i] / 1e6;
+			double meanUs  = total.timerCalls[i] ? total.timerNanos[i] / 1e3 / total.timerCalls[i] : 0;
+			out << left << setw(24) << timerNames[i] << right
+				<< setw(14) << total.timerCalls[i] << " calls "
+				<< setw(12) << fixed << setprecision(3) << totalMs << " ms "
+				<< setw(10) << meanUs << " us/call" << '\n';
+		}
+		out.flags ( flags );
+		out.precision ( precision );
+		out << flush;
+	}
+}
@@ -0,0 +1,100 @@
+// ======================================================================
+// FILE:        Profiler.hpp
+//
+// DESCRIPTION: This file contains the hot-path instrumentation used by
+//              the engine and MyAI: event counters and scoped timers.
+//              Every thread accumulates into its own thread-local
+//              statistics block, so instrumented code never contends
+//              on a lock; the blocks are merged when a summary is
+//              printed.
+//
+// NOTES:       - Instrumentation is compiled in only when WW_PROFILE is
+//                defined (e.g. g++ -DWW_PROFILE ...). Otherwise the
+//                PROFILE_COUNT and PROFILE_TIMER macros expand to
+//                nothing and cost nothing.
+//
+//              - To add a counter or timer, add it to the enum and give
+//                it a name in Profiler.cpp.
+// ======================================================================
+
+#ifndef PROFILER_LOCK
+#define PROFILER_LOCK
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace Profiler
+{
+	enum Counter
+	{
+		WORLD_TURN_LEFT,		// Actions the engine applied, by type
+		WORLD_TURN_RIGHT,
+		WORLD_FORWARD,
+		WORLD_SHOOT,
+		WORLD_GRAB,
+		WORLD_CLIMB,
+		MYAI_INFER_SAFE_TILE,	// inferSafeTile() calls
+		MYAI_QUEUE_PUSH,		// Action queue churn
+		MYAI_QUEUE_POP,
+		MYAI_QUEUE_CLEAR,
+		NUM_COUNTERS
+	};
+
+	enum Timer
+	{
+		TIMER_WORLD_RUN,		// One whole game
+		TIMER_GET_ACTION,		// MyAI::getAction
+		TIMER_SHORTEST_PATH,	// MyAI::shortestPath
+		NUM_TIMERS
+	};
+
+	struct Stats
+	{
+		uint64_t	counters	[NUM_COUNTERS] = {};
+		uint64_t	timerCalls	[NUM_TIMERS]   = {};
+		uint64_t	timerNanos	[NUM_TIMERS]   = {};
+
+		void merge ( const Stats& other );
+	};
+
+	// The calling thread's statistics block
+	Stats&	local	( void );
+
+	// Sums the blocks of every thread, live or finished
+	Stats	collect	( void );
+
+	// Prints the collected statistics as a table
+	void	printSummary	( std::ostream& out );
+
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer ( Timer _timer ) : timer ( _timer ), start ( std::chrono::steady_clock::now() ) {}
+
+		~ScopedTimer()
+		{
+			Stats& stats = local();
+			++stats.timerCalls[timer];
+			stats.timerNanos[timer] += std::chrono::duration_cast<std::chrono::nanoseconds>
+				( std::chrono::steady_clock::now() - start ).count();
+		}
+
+	private:
+		Timer	timer;
+		std::chrono::steady_clock::time_point	start;
+	};
+}
+
+#define PROFILE_CONCAT_INNER( a, b ) a##b
+#define PROFILE_CONCAT( a, b ) PROFILE_CONCAT_INNER( a, b )
+
+#ifdef WW_PROFILE
+	#define PROFILE_COUNT( counter )	( ++Profiler::local().counters[Profiler::counter] )
+	#define PROFILE_TIMER( timer )		Profiler::ScopedTimer PROFILE_CONCAT( profileTimer, __LINE__ ) ( Profiler::timer )
+#else
+	#define PROFILE_COUNT( counter )	( (void) 0 )
+	#define PROFILE_TIMER( timer )		( (void) 0 )
+#endif
+
+#endif /* PROFILER_LOCK */
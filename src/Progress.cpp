@@ -0,0 +1,109 @@
+// ======================================================================
+// FILE:        Progress.cpp
+//
+// DESCRIPTION: This file contains the progress reporter, which prints
+//              the progress of a folder run from a side thread.
+// ======================================================================
+
+#include "Progress.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+using namespace std;
+
+ProgressReporter::ProgressReporter
+(
+	size_t						_total,
+	chrono::milliseconds		_interval,
+	const string&				_file,
+	function<string ( size_t )>	_nameOf
+)
+	: total ( _total ), interval ( _interval ), file ( _file ), nameOf ( move ( _nameOf ) ),
+	  started ( chrono::steady_clock::now() )
+{
+	reporter = thread ( [this]
+	{
+		unique_lock<mutex> lock ( stopLock );
+		while ( !stopSignal.wait_for ( lock, interval, [this] { return stopping; } ) )
+		{
+			lock.unlock();
+			report();
+			lock.lock();
+		}
+	} );
+}
+
+ProgressReporter::~ProgressReporter ( void )
+{
+	{
+		lock_guard<mutex> lock ( stopLock );
+		stopping = true;
+	}
+	stopSignal.notify_one();
+	reporter.join();
+	report();
+}
+
+void ProgressReporter::add ( size_t games, int score, chrono::nanoseconds elapsed, size_t world )
+{
+	done.fetch_add ( games, memory_order_relaxed );
+	scoreSum.fetch_add ( (int64_t) score * games, memory_order_relaxed );
+
+	int64_t nanoseconds = elapsed.count();
+	if ( nanoseconds <= slowestHint.load ( memory_order_relaxed ) )
+		return;
+
+	lock_guard<mutex> lock ( slowestLock );
+	if ( nanoseconds > slowest )
+	{
+		slowest      = nanoseconds;
+		slowestWorld = world;
+		slowestHint.store ( nanoseconds, memory_order_relaxed );
+	}
+}
+
+void ProgressReporter::report ( void )
+{
+	uint64_t	games   = done.load ( memory_order_relaxed );
+	int64_t		sum     = scoreSum.load ( memory_order_relaxed );
+	double		seconds = chrono::duration<double> ( chrono::steady_clock::now() - started ).count();
+	double		rate    = seconds > 0 ? games / seconds : 0;
+	double		eta     = rate > 0 && games < total ? ( total - games ) / rate : 0;
+	double		mean    = games > 0 ? (double) sum / games : 0;
+
+	int64_t		slowestTime;
+	size_t		world;
+	{
+		lock_guard<mutex> lock ( slowestLock );
+		slowestTime = slowest;
+		world       = slowestWorld;
+	}
+	string name = slowestTime > 0 ? nameOf ( world ) : "none";
+
+	ostringstream line;
+	line.precision ( 4 );
+	line << "[PROGRESS] " << games << "/" << total << " games, " << (uint64_t) rate << " games/s, ETA "
+		 << eta << " s, mean " << mean << ", slowest " << name << " (" << slowestTime / 1e6 << " ms)\n";
+	cerr << line.str() << flush;
+
+	if ( file.empty() )
+		return;
+
+	// Written beside the file and renamed over it, so a reader never
+	// sees half a report
+	string partial = file + ".partial";
+	{
+		ofstream out ( partial );
+		out << "GAMES: " << games << "\n";
+		out << "TOTAL: " << total << "\n";
+		out << "RATE: " << rate << "\n";
+		out << "ETA: " << eta << "\n";
+		out << "MEAN: " << mean << "\n";
+		out << "SLOWEST: " << name << "\n";
+		out << "SLOWEST_US: " << slowestTime / 1000 << "\n";
+	}
+	rename ( partial.c_str(), file.c_str() );
+}
@@ -0,0 +1,95 @@
+// ======================================================================
+// FILE:        Progress.hpp
+//
+// DESCRIPTION: This file contains the progress reporter, which shows how
+//              far a long folder run has got while it runs. The playing
+//              thread only bumps counters; a side thread wakes up every
+//              interval to print the games done, the games per second,
+//              the time left, the running mean score and the slowest
+//              world so far.
+//
+// NOTES:       - Report lines go to standard error, so standard output
+//                keeps the usual results:
+//
+//                  [PROGRESS] 1200/2000 games, 5400 games/s, ETA 0.1 s,
+//                             mean 281.3, slowest world_12.txt (3.1 ms)
+//
+//              - With a file, every report also replaces the file's
+//                contents with the same figures, one per line:
+//
+//                  GAMES: <done>
+//                  TOTAL: <to play>
+//                  RATE: <games per second>
+//                  ETA: <seconds left>
+//                  MEAN: <mean score so far>
+//                  SLOWEST: <world name>
+//                  SLOWEST_US: <its game time in microseconds>
+//
+//                so a dashboard can poll it.
+//
+//              - add() is a few relaxed atomic increments, and takes a
+//                lock only when a game is the slowest yet. Any number of
+//                threads may call it.
+// ======================================================================
+
+#ifndef PROGRESS_LOCK
+#define PROGRESS_LOCK
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class ProgressReporter
+{
+public:
+
+	// Starts reporting on a run of 'total' games. 'nameOf' names a world
+	// by the index passed to add(); it is only called from the reporting
+	// thread. With an empty 'file', reports are only printed.
+	ProgressReporter
+	(
+		size_t									total,
+		std::chrono::milliseconds				interval,
+		const std::string&						file,
+		std::function<std::string ( size_t )>	nameOf
+	);
+
+	// Stops the side thread after one last report
+	~ProgressReporter ( void );
+
+	ProgressReporter ( const ProgressReporter& ) = delete;
+	ProgressReporter& operator= ( const ProgressReporter& ) = delete;
+
+	// Counts 'games' games that scored 'score' each. 'elapsed' is the time
+	// spent playing them once, zero if they were not played.
+	void	add		( size_t games, int score, std::chrono::nanoseconds elapsed, size_t world );
+
+private:
+	size_t									total;
+	std::chrono::milliseconds				interval;
+	std::string								file;
+	std::function<std::string ( size_t )>	nameOf;
+	std::chrono::steady_clock::time_point	started;
+
+	std::atomic<uint64_t>	done     { 0 };
+	std::atomic<int64_t>	scoreSum { 0 };
+	std::atomic<int64_t>	slowestHint { 0 };	// Nanoseconds; lets add() skip the lock
+
+	std::mutex				slowestLock;
+	int64_t					slowest      = 0;
+	size_t					slowestWorld = 0;
+
+	std::mutex				stopLock;
+	std::condition_variable	stopSignal;
+	bool					stopping = false;
+	std::thread				reporter;
+
+	void	report	( void );
+};
+
+#endif /* PROGRESS_LOCK */
@@ -0,0 +1,47 @@
+// ======================================================================
+// FILE:        Random.hpp
+//
+// DESCRIPTION: This file contains SplitMix64, a small, fast random
+//              number generator with 64 bits of state. Unlike rand(),
+//              each generator is an independent object, so code that
+//              owns one is reproducible from its seed and safe to run
+//              on several threads at once.
+// ======================================================================
+
+#ifndef RANDOM_LOCK
+#define RANDOM_LOCK
+
+#include <cstdint>
+
+class SplitMix64
+{
+public:
+
+	explicit SplitMix64 ( uint64_t seed = 0 ) : state ( seed ) {}
+
+	uint64_t next ( void )
+	{
+		uint64_t z = ( state += 0x9E3779B97F4A7C15ULL );
+		z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+		z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+		return z ^ ( z >> 31 );
+	}
+
+	// Uniform in [0, limit); the modulo bias is negligible for the
+	// small limits used here
+	int uniform ( int limit )
+	{
+		return static_cast<int> ( next() % static_cast<uint64_t> ( limit ) );
+	}
+
+	// Uniform in [0, 1)
+	double real ( void )
+	{
+		return ( next() >> 11 ) * ( 1.0 / 9007199254740992.0 );
+	}
+
+private:
+	uint64_t state;
+};
+
+#endif /* RANDOM_LOCK */
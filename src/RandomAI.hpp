@@ -15,13 +15,16 @@
 #ifndef RANDOMAI_LOCK
 #define RANDOMAI_LOCK
 
-#include <cstdlib>
+#include <cstdint>
 #include "Agent.hpp"
+#include "Random.hpp"
 
 class RandomAI : public Agent
 {
 public:
 
+	explicit RandomAI ( uint64_t seed = 0 ) : random ( seed ) {}
+
 	Action getAction
 	(
 		bool stench,
@@ -34,11 +37,29 @@ public:
 		if ( glitter )
 			return GRAB;
 		
-		return actions [ rand() % 6 ];
+		return actions [ random.uniform ( 6 ) ];
+	}
+	
+	Agent* clone ( void ) const
+	{
+		return new RandomAI ( *this );
+	}
+	
+	void reset ( uint64_t seed )
+	{
+		random = SplitMix64 ( seed );
+	}
+	
+	// Bump the number whenever the agent's moves change
+	const char* buildId ( void ) const
+	{
+		return "RandomAI 1";
 	}
 	
 private:
 
+	SplitMix64 random;
+
 	const Action actions[6] =
 	{
 		TURN_LEFT,
@@ -0,0 +1,224 @@
+// ======================================================================
+// FILE:        ResultCache.cpp
+//
+// DESCRIPTION: This file contains the result cache, which keeps the
+//              scores of -f runs on disk.
+// ======================================================================
+
+#include "ResultCache.hpp"
+#include "Hash.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char MAGIC[8] = { 'W', 'W', 'R', 'C', 'A', 'C', 'H', 'E' };
+
+static size_t fileSize ( uint64_t capacity )
+{
+	return 24 + capacity * 16;
+}
+
+// Sizes an empty file for the capacity and writes its header
+static bool initialize ( int file, uint64_t capacity )
+{
+	if ( ftruncate ( file, fileSize ( capacity ) ) != 0 )
+		return false;
+
+	char header[24];
+	uint64_t count = 0;
+	memcpy ( header,      MAGIC,     8 );
+	memcpy ( header + 8,  &capacity, 8 );
+	memcpy ( header + 16, &count,    8 );
+	return pwrite ( file, header, sizeof header, 0 ) == sizeof header;
+}
+
+bool ResultCache::open ( const string& _path )
+{
+	static_assert ( sizeof ( Header ) == 24 && sizeof ( Slot ) == 16, "ResultCache file layout changed" );
+
+	close();
+
+	for ( ;; )
+	{
+		int file = ::open ( _path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+		if ( file < 0 )
+			return false;
+
+		struct stat opened, named;
+		if ( flock ( file, LOCK_EX ) != 0 || fstat ( file, &opened ) != 0 )
+		{
+			::close ( file );
+			return false;
+		}
+
+		// Another process may have replaced the file by growing it while
+		// this one waited for the lock
+		if ( stat ( _path.c_str(), &named ) != 0 || named.st_ino != opened.st_ino || named.st_dev != opened.st_dev )
+		{
+			::close ( file );
+			continue;
+		}
+
+		if ( ( opened.st_size == 0 && !initialize ( file, INITIAL_CAPACITY ) ) || !map ( file ) )
+		{
+			::close ( file );
+			return false;
+		}
+
+		path = _path;
+		return true;
+	}
+}
+
+void ResultCache::close ( void )
+{
+	unmap();
+	if ( fd >= 0 )
+		::close ( fd );
+	fd = -1;
+}
+
+bool ResultCache::map ( int file )
+{
+	struct stat info;
+	if ( fstat ( file, &info ) != 0 || (size_t) info.st_size < sizeof ( Header ) )
+		return false;
+
+	void* memory = mmap ( NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0 );
+	if ( memory == MAP_FAILED )
+		return false;
+
+	Header* mapped   = static_cast<Header*> ( memory );
+	uint64_t capacity = mapped->capacity;
+	if ( memcmp ( mapped->magic, MAGIC, sizeof MAGIC ) != 0 || capacity == 0 || ( capacity & ( capacity - 1 ) ) != 0
+			|| (size_t) info.st_size != fileSize ( capacity ) || mapped->count > capacity )
+	{
+		munmap ( memory, info.st_size );
+		return false;
+	}
+
+	fd     = file;
+	header = mapped;
+	slots  = reinterpret_cast<Slot*> ( mapped + 1 );
+	return true;
+}
+
+void ResultCache::unmap ( void )
+{
+	if ( header != NULL )
+		munmap ( header, fileSize ( header->capacity ) );
+	header = NULL;
+	slots  = NULL;
+}
+
+uint64_t ResultCache::makeKey ( uint64_t world, const char* buildId, uint64_t seed )
+{
+	uint32_t engine = ENGINE_VERSION;
+	uint64_t hash   = Hash::fnv1a ( &engine, sizeof engine );
+	hash = Hash::fnv1a ( &world, sizeof world, hash );
+	hash = Hash::fnv1a ( buildId, strlen ( buildId ) + 1, hash );
+	return Hash::fnv1a ( &seed, sizeof seed, hash );
+}
+
+ResultCache::Slot* ResultCache::probe ( Slot* slots, uint64_t capacity, uint64_t key )
+{
+	uint64_t mask  = capacity - 1;
+	uint64_t index = ( key ^ key >> 32 ) & mask;
+
+	while ( slots[index].used && slots[index].key != key )
+		index = ( index + 1 ) & mask;
+	return &slots[index];
+}
+
+bool ResultCache::find ( uint64_t key, int& score )
+{
+	++lookups;
+	if ( header == NULL )
+		return false;
+
+	const Slot* slot = probe ( slots, header->capacity, key );
+	if ( !slot->used )
+		return false;
+
+	score = slot->score;
+	++hits;
+	return true;
+}
+
+bool ResultCache::insert ( uint64_t key, int score )
+{
+	if ( header == NULL )
+		return false;
+
+	Slot* slot = probe ( slots, header->capacity, key );
+	if ( slot->used )
+		return true;
+
+	if ( ( header->count + 1 ) * 4 > header->capacity * 3 )
+	{
+		if ( !grow() )
+			return false;
+		slot = probe ( slots, header->capacity, key );
+	}
+
+	slot->key   = key;
+	slot->score = score;
+	slot->used  = 1;
+	++header->count;
+	return true;
+}
+
+bool ResultCache::grow ( void )
+{
+	uint64_t	capacity = header->capacity * 2;
+	string		grown    = path + ".grow";
+
+	// Locked before it is renamed into place, so a process that opens it
+	// waits for this one to finish
+	int file = ::open ( grown.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+	if ( file < 0 )
+		return false;
+	if ( flock ( file, LOCK_EX ) != 0 || !initialize ( file, capacity ) )
+	{
+		::close ( file );
+		unlink ( grown.c_str() );
+		return false;
+	}
+
+	Header*	oldHeader = header;
+	Slot*	oldSlots  = slots;
+	int		oldFd     = fd;
+	if ( !map ( file ) )
+	{
+		::close ( file );
+		unlink ( grown.c_str() );
+		return false;
+	}
+
+	for ( uint64_t index = 0; index < oldHeader->capacity; ++index )
+		if ( oldSlots[index].used )
+			*probe ( slots, capacity, oldSlots[index].key ) = oldSlots[index];
+	header->count = oldHeader->count;
+
+	// Renamed before the old file's lock is released, so a process
+	// waiting on the old file sees it was replaced
+	if ( rename ( grown.c_str(), path.c_str() ) != 0 )
+	{
+		close();
+		unlink ( grown.c_str() );
+		fd     = oldFd;
+		header = oldHeader;
+		slots  = oldSlots;
+		return false;
+	}
+
+	munmap ( oldHeader, fileSize ( oldHeader->capacity ) );
+	::close ( oldFd );
+	return true;
+}
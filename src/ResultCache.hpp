@@ -0,0 +1,107 @@
+// ======================================================================
+// FILE:        ResultCache.hpp
+//
+// DESCRIPTION: This file contains the result cache, which keeps the
+//              scores of -f runs on disk so a rerun only plays the
+//              worlds whose score it does not know yet. A score is keyed
+//              by the board (WorldDescription::key), the agent's build
+//              id (Agent::buildId) and, for agents that are not
+//              deterministic, the game's seed. Changing one agent only
+//              invalidates that agent's scores.
+//
+// NOTES:       - The file is an open addressing hash table with linear
+//                probing, mapped into memory, so a lookup touches one or
+//                two pages however large the file grows:
+//
+//                  Header: magic "WWRCACHE", capacity, count (uint64)
+//                  Slots:  capacity x { key (uint64), score (int32),
+//                                       used (uint32) }
+//
+//                Entries are only ever appended. When the table is three
+//                quarters full, it is rebuilt at twice the size into a
+//                new file that replaces the old one.
+//
+//              - One process uses a file at a time: open() takes an
+//                exclusive lock that is held until the cache closes, so
+//                concurrent runs sharing a cache take turns.
+//
+//              - Scores also depend on the engine, so ENGINE_VERSION is
+//                part of every key. Bump it with any change to the rules
+//                or scoring of World or FixedWorld, and the scores of the
+//                old engine are no longer found.
+// ======================================================================
+
+#ifndef RESULTCACHE_LOCK
+#define RESULTCACHE_LOCK
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class ResultCache
+{
+public:
+
+	ResultCache ( void ) {}
+	~ResultCache ( void ) { close(); }
+
+	ResultCache ( const ResultCache& ) = delete;
+	ResultCache& operator= ( const ResultCache& ) = delete;
+
+	// Opens the cache file, creating it if it does not exist. Returns
+	// false if it cannot be created, locked or mapped, or is not a
+	// result cache.
+	bool	open	( const std::string& path );
+	void	close	( void );
+
+	// The version of the game engine that cached scores come from
+	static const uint32_t ENGINE_VERSION = 1;
+
+	// Combines the parts of a key with ENGINE_VERSION. 'seed' should be
+	// 0 for deterministic agents, whose score does not depend on it.
+	static uint64_t	makeKey	( uint64_t world, const char* buildId, uint64_t seed );
+
+	// Returns true and sets 'score' if the key is cached
+	bool	find	( uint64_t key, int& score );
+
+	// Records a score; a key that is already cached keeps its score.
+	// Returns false if the table could not grow.
+	bool	insert	( uint64_t key, int score );
+
+	size_t	size		( void ) const { return header == NULL ? 0 : header->count; }
+	size_t	getHits		( void ) const { return hits; }
+	size_t	getLookups	( void ) const { return lookups; }
+
+private:
+	struct Header
+	{
+		char		magic[8];
+		uint64_t	capacity;		// A power of two
+		uint64_t	count;
+	};
+
+	struct Slot
+	{
+		uint64_t	key;
+		int32_t		score;
+		uint32_t	used;			// Nonzero once the slot holds an entry
+	};
+
+	static const uint64_t	INITIAL_CAPACITY = 1 << 16;
+
+	std::string	path;
+	int			fd      = -1;
+	Header*		header  = NULL;
+	Slot*		slots   = NULL;
+	size_t		hits    = 0;
+	size_t		lookups = 0;
+
+	bool	map		( int file );
+	void	unmap	( void );
+	bool	grow	( void );
+
+	// The slot holding the key, or the empty slot where it would go
+	static Slot*	probe	( Slot* slots, uint64_t capacity, uint64_t key );
+};
+
+#endif /* RESULTCACHE_LOCK */
@@ -0,0 +1,89 @@
+// ======================================================================
+// FILE:        ScoutAI.hpp
+//
+// DESCRIPTION: This file contains ScoutAI, a small agent written as a
+//              coroutine plan (see CoroutineAgent.hpp). It walks along
+//              the bottom row while the cell it stands on is quiet,
+//              grabs the gold if it finds it, then walks back the way it
+//              came and climbs out. It only ever steps next to a quiet
+//              cell, so it never dies.
+//
+// NOTES:       - Registered as "scout" in AgentRegistry, and only built
+//                when coroutines are available (WW_COROUTINES).
+//
+//              - The whole game is one straight-line plan: the steps
+//                taken are a local variable of the coroutine rather than
+//                state kept between calls to getAction().
+// ======================================================================
+
+#ifndef SCOUTAI_LOCK
+#define SCOUTAI_LOCK
+
+#include "CoroutineAgent.hpp"
+
+#ifdef WW_COROUTINES
+
+class ScoutAI : public CoroutineAgent
+{
+public:
+
+	Agent* clone ( void ) const
+	{
+		return new ScoutAI;
+	}
+
+	bool isDeterministic ( void ) const
+	{
+		return true;
+	}
+
+	// Bump the number whenever the agent's moves change
+	const char* buildId ( void ) const
+	{
+		return "ScoutAI 1";
+	}
+
+protected:
+
+	Plan makePlan ( void )
+	{
+		int			steps    = 0;
+		Percepts	percepts = co_await CoroutineAgent::percepts();
+
+		for ( ;; )
+		{
+			if ( percepts.glitter )
+			{
+				co_yield GRAB;
+				break;
+			}
+
+			// The last step hit the wall and went nowhere
+			if ( percepts.bump )
+			{
+				--steps;
+				break;
+			}
+
+			if ( percepts.breeze || percepts.stench )
+				break;
+
+			co_yield FORWARD;
+			++steps;
+			percepts = co_await CoroutineAgent::percepts();
+		}
+
+		if ( steps > 0 )
+		{
+			co_yield TURN_LEFT;
+			co_yield TURN_LEFT;
+			for ( ; steps > 0; --steps )
+				co_yield FORWARD;
+		}
+		co_yield CLIMB;
+	}
+};
+
+#endif /* WW_COROUTINES */
+
+#endif /* SCOUTAI_LOCK */
@@ -0,0 +1,624 @@
+// ======================================================================
+// FILE:        Search.cpp
+//
+// DESCRIPTION: This file contains the adversarial world search, which
+//              hill-climbs over boards towards ones the agent fails on.
+// ======================================================================
+
+#include "Search.hpp"
+#include "AgentRegistry.hpp"
+#include "World.hpp"
+#include "Solver.hpp"
+#include "Compass.hpp"
+#include "Random.hpp"
+#include "Hash.hpp"
+#include "Affinity.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <unordered_set>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// ===============================================================
+// =						Board
+// ===============================================================
+
+namespace
+{
+	// A board being searched, kept as the state of a game about to start
+	// so it can be played without a rebuild. Edits keep the breeze and
+	// stench of the tiles around them up to date.
+	class Board
+	{
+	public:
+
+		World::GameState	state;
+
+		Board ( int cols, int rows )
+		{
+			state.colDimension = cols;
+			state.rowDimension = rows;
+		}
+
+		int		cols	( void ) const { return state.colDimension; }
+		int		rows	( void ) const { return state.rowDimension; }
+
+		bool	isInBounds	( int c, int r ) const { return c >= 0 && c < cols() && r >= 0 && r < rows(); }
+		bool	isPit		( int c, int r ) const { return state.board[c][r].pit; }
+
+		void setPit ( int c, int r, bool pit )
+		{
+			state.board[c][r].pit = pit;
+			for ( int d = 0; d < 4; ++d )
+				refreshBreeze ( c + Compass::DX[d], r + Compass::DY[d] );
+		}
+
+		// There is only one wumpus, so the cells around its old place
+		// smell of nothing once it has moved
+		void moveWumpus ( int c, int r )
+		{
+			placeWumpus ( false );
+			wumpus = { c, r };
+			placeWumpus ( true );
+		}
+
+		void moveGold ( int c, int r )
+		{
+			state.board[gold.c][gold.r].gold = false;
+			gold = { c, r };
+			state.board[gold.c][gold.r].gold = true;
+		}
+
+		WorldDescription describe ( void ) const
+		{
+			WorldDescription description;
+			description.colDimension = cols();
+			description.rowDimension = rows();
+			description.wumpus       = wumpus;
+			description.gold         = gold;
+			for ( int c = 0; c < cols(); ++c )
+				for ( int r = 0; r < rows(); ++r )
+					if ( isPit ( c, r ) )
+						description.pits.push_back ( { c, r } );
+			return description;
+		}
+
+		WorldDescription::Cell	wumpus = { 0, 0 };
+		WorldDescription::Cell	gold   = { 0, 0 };
+
+	private:
+
+		void refreshBreeze ( int c, int r )
+		{
+			if ( !isInBounds ( c, r ) )
+				return;
+
+			bool breeze = false;
+			for ( int d = 0; d < 4; ++d )
+			{
+				int x = c + Compass::DX[d];
+				int y = r + Compass::DY[d];
+				breeze = breeze || ( isInBounds ( x, y ) && isPit ( x, y ) );
+			}
+			state.board[c][r].breeze = breeze;
+		}
+
+		void placeWumpus ( bool present )
+		{
+			state.board[wumpus.c][wumpus.r].wumpus = present;
+			for ( int d = 0; d < 4; ++d )
+			{
+				int x = wumpus.c + Compass::DX[d];
+				int y = wumpus.r + Compass::DY[d];
+				if ( isInBounds ( x, y ) )
+					state.board[x][y].stench = present;
+			}
+		}
+	};
+}
+
+// ===============================================================
+// =					Crash Guard
+// ===============================================================
+
+namespace
+{
+	// What a worker is playing, for the fatal signal handler
+	struct CrashGuard
+	{
+		const Board*	board = NULL;	// Set only while a game is played
+		char			path[1024];		// Where to write the board
+	};
+
+	thread_local CrashGuard* guard = NULL;
+
+	const int FATAL_SIGNALS[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+
+	// Only async-signal-safe code from here to the end of the handler
+
+	void append ( char*& out, const char* text )
+	{
+		while ( *text )
+			*out++ = *text++;
+	}
+
+	void append ( char*& out, int number )
+	{
+		char	digits[12];
+		int		count = 0;
+		do
+			digits[count++] = static_cast<char> ( '0' + number % 10 );
+		while ( ( number /= 10 ) > 0 );
+		while ( count > 0 )
+			*out++ = digits[--count];
+	}
+
+	// One line of the text format: "<a> <b>"
+	void appendPair ( char*& out, int a, int b )
+	{
+		append ( out, a );
+		append ( out, " " );
+		append ( out, b );
+		append ( out, "\n" );
+	}
+
+	void onFatalSignal ( int signal )
+	{
+		if ( guard && guard->board )
+		{
+			const Board&	board = *guard->board;
+			char			text[64 + WorldDescription::MAX_DIMENSION * WorldDescription::MAX_DIMENSION * 8];
+			char*			out   = text;
+			int				pits  = 0;
+
+			for ( int c = 0; c < board.cols(); ++c )
+				for ( int r = 0; r < board.rows(); ++r )
+					pits += board.isPit ( c, r );
+
+			appendPair ( out, board.cols(), board.rows() );
+			appendPair ( out, board.wumpus.c, board.wumpus.r );
+			appendPair ( out, board.gold.c, board.gold.r );
+			append ( out, pits );
+			append ( out, "\n" );
+			for ( int c = 0; c < board.cols(); ++c )
+				for ( int r = 0; r < board.rows(); ++r )
+					if ( board.isPit ( c, r ) )
+						appendPair ( out, c, r );
+
+			int file = open ( guard->path, O_WRONLY | O_CREAT | O_TRUNC, 0666 );
+			if ( file >= 0 )
+			{
+				ssize_t ignored = write ( file, text, out - text );
+				( void ) ignored;
+				close ( file );
+			}
+
+			char	message[sizeof guard->path + 64];
+			char*	end = message;
+			append ( end, "[CRASH] The agent crashed the process; its board is in " );
+			append ( end, guard->path );
+			append ( end, "\n" );
+			ssize_t ignored = write ( STDERR_FILENO, message, end - message );
+			( void ) ignored;
+		}
+
+		::signal ( signal, SIG_DFL );
+		raise ( signal );
+	}
+}
+
+// ===============================================================
+// =						Search
+// ===============================================================
+
+struct SearchOptions
+{
+	int			minSize    = 4;
+	int			maxSize    = 7;
+	double		pitDensity = 0.2;
+	uint64_t	games      = 100000;
+	double		seconds    = 0;		// 0 for no time limit
+	int			below      = -1000;
+	bool		useRegret  = false;
+	int			regret     = 0;
+	int			patience   = 200;
+	uint64_t	seed       = 0;
+	int			threads    = Affinity::defaultThreads();
+	bool		pin        = false;
+};
+
+namespace
+{
+	// How the agent did on a board
+	struct Result
+	{
+		int		score   = 0;
+		int		regret  = 0;
+		bool	crashed = false;
+		int		fitness = INT_MIN;	// Higher is worse for the agent
+	};
+
+	string fileName ( uint64_t key )
+	{
+		char name[64];
+		snprintf ( name, sizeof name, "search_%016llx.txt", static_cast<unsigned long long> ( key ) );
+		return name;
+	}
+
+	// State shared by the workers; only touched when a board is saved
+	struct Findings
+	{
+		mutex					lock;
+		unordered_set<uint64_t>	saved;
+		size_t					crashes  = 0;
+		size_t					failures = 0;
+	};
+
+	class Searcher
+	{
+	public:
+
+		Searcher ( const SearchOptions& options, const string& agentName, const string& folder,
+				Findings& findings, int worker )
+			: options ( options ), folder ( folder ), findings ( findings ),
+			  random ( Hash::fnv1a ( &worker, sizeof worker, options.seed ) ),
+			  world ( WorldDescription(), AgentRegistry::make ( agentName ) )
+		{
+			unique_ptr<Agent> probe ( AgentRegistry::make ( agentName ) );
+			deterministic = probe->isDeterministic();
+
+			snprintf ( crash.path, sizeof crash.path, "%s/search_crash_%d.txt", folder.c_str(), worker );
+			guard = &crash;
+		}
+
+		~Searcher ( void )
+		{
+			guard = NULL;
+		}
+
+		// Plays up to 'quota' games, or until 'deadline' if 'timed'.
+		// Returns the games played.
+		uint64_t run ( uint64_t quota, bool timed, chrono::steady_clock::time_point deadline )
+		{
+			uint64_t	played  = 0;
+			Board		current = randomBoard();
+			Result		best    = evaluate ( current );
+			int			stale   = 0;
+
+			for ( ++played; played < quota; ++played )
+			{
+				if ( timed && played % 256 == 0 && chrono::steady_clock::now() >= deadline )
+					break;
+
+				if ( failed ( best ) || stale >= options.patience )
+				{
+					if ( failed ( best ) )
+						save ( current, best );
+					current = randomBoard();
+					best    = evaluate ( current );
+					stale   = 0;
+					continue;
+				}
+
+				Board candidate = current;
+				for ( int edits = 1 + random.uniform ( 2 ); edits > 0; --edits )
+					mutate ( candidate );
+
+				Result result = evaluate ( candidate );
+				stale = result.fitness > best.fitness ? 0 : stale + 1;
+
+				// Sideways moves are kept too, so the climb can cross
+				// plateaus of equal scores
+				if ( result.fitness >= best.fitness )
+				{
+					current = candidate;
+					best    = result;
+				}
+			}
+
+			if ( failed ( best ) )
+				save ( current, best );
+			return played;
+		}
+
+	private:
+		const SearchOptions&	options;
+		const string&			folder;
+		Findings&				findings;
+		SplitMix64				random;
+		World					world;
+		bool					deterministic;
+		CrashGuard				crash;
+
+		WorldDescription::Cell randomCell ( const Board& board )
+		{
+			WorldDescription::Cell cell;
+			do
+				cell = { random.uniform ( board.cols() ), random.uniform ( board.rows() ) };
+			while ( cell.c == 0 && cell.r == 0 );
+			return cell;
+		}
+
+		// A neighbour of 'cell' other than the start, or a random cell
+		// if the neighbour drawn is off the board or the start
+		WorldDescription::Cell nearCell ( const Board& board, WorldDescription::Cell cell )
+		{
+			int d = random.uniform ( 4 );
+			WorldDescription::Cell next = { cell.c + Compass::DX[d], cell.r + Compass::DY[d] };
+			if ( !board.isInBounds ( next.c, next.r ) || ( next.c == 0 && next.r == 0 ) )
+				return randomCell ( board );
+			return next;
+		}
+
+		// Follows the random world rules of World::addFeatures, with the
+		// pit density of the options
+		Board randomBoard ( void )
+		{
+			Board board ( options.minSize + random.uniform ( options.maxSize - options.minSize + 1 ),
+						  options.minSize + random.uniform ( options.maxSize - options.minSize + 1 ) );
+
+			for ( int r = 0; r < board.rows(); ++r )
+				for ( int c = 0; c < board.cols(); ++c )
+					if ( ( c != 0 || r != 0 ) && random.real() < options.pitDensity )
+						board.setPit ( c, r, true );
+
+			WorldDescription::Cell wumpus = randomCell ( board );
+			board.moveWumpus ( wumpus.c, wumpus.r );
+			WorldDescription::Cell gold = randomCell ( board );
+			board.moveGold ( gold.c, gold.r );
+			return board;
+		}
+
+		void mutate ( Board& board )
+		{
+			switch ( random.uniform ( 4 ) )
+			{
+				case 0:
+				{
+					WorldDescription::Cell cell = randomCell ( board );
+					board.setPit ( cell.c, cell.r, !board.isPit ( cell.c, cell.r ) );
+					break;
+				}
+
+				case 1:
+				{
+					// Pick a pit by reservoir sampling over the board
+					WorldDescription::Cell	pit   = { 0, 0 };
+					int						count = 0;
+					for ( int c = 0; c < board.cols(); ++c )
+						for ( int r = 0; r < board.rows(); ++r )
+							if ( board.isPit ( c, r ) && random.uniform ( ++count ) == 0 )
+								pit = { c, r };
+					if ( count == 0 )
+						break;
+
+					WorldDescription::Cell next = nearCell ( board, pit );
+					if ( !board.isPit ( next.c, next.r ) )
+					{
+						board.setPit ( pit.c, pit.r, false );
+						board.setPit ( next.c, next.r, true );
+					}
+					break;
+				}
+
+				case 2:
+				{
+					WorldDescription::Cell cell = random.uniform ( 2 ) ? nearCell ( board, board.wumpus ) : randomCell ( board );
+					board.moveWumpus ( cell.c, cell.r );
+					break;
+				}
+
+				case 3:
+				{
+					WorldDescription::Cell cell = random.uniform ( 2 ) ? nearCell ( board, board.gold ) : randomCell ( board );
+					board.moveGold ( cell.c, cell.r );
+					break;
+				}
+			}
+		}
+
+		Result evaluate ( const Board& board )
+		{
+			Result result;
+
+			// Deterministic agents play the same whatever the seed, so the
+			// key is only worked out for the others
+			uint64_t seed = deterministic ? 0 : Hash::fnv1a ( fileName ( board.describe().key() ), options.seed );
+
+			crash.board = &board;
+			try
+			{
+				world.reset ( board.state, seed );
+				result.score = world.run();
+			}
+			catch (...)
+			{
+				result.crashed = true;
+			}
+			crash.board = NULL;
+
+			if ( result.crashed )
+				result.fitness = INT_MAX;
+			else if ( options.useRegret )
+			{
+				result.regret  = optimalScore ( board.describe() ) - result.score;
+				result.fitness = result.regret;
+			}
+			else
+				result.fitness = -result.score;
+			return result;
+		}
+
+		bool failed ( const Result& result ) const
+		{
+			if ( result.crashed )
+				return true;
+			return options.useRegret ? result.regret >= options.regret : result.score < options.below;
+		}
+
+		void save ( const Board& board, const Result& result )
+		{
+			WorldDescription	description = board.describe();
+			string				name        = fileName ( description.key() );
+
+			lock_guard<mutex> lock ( findings.lock );
+			if ( !findings.saved.insert ( description.key() ).second )
+				return;
+
+			ofstream file ( folder + "/" + name );
+			description.write ( file );
+
+			cout << "[FOUND] " << name << ": ";
+			if ( result.crashed )
+			{
+				++findings.crashes;
+				cout << "the agent threw" << endl;
+			}
+			else
+			{
+				++findings.failures;
+				if ( options.useRegret )
+					cout << "regret " << result.regret << " (scored " << result.score << ")" << endl;
+				else
+					cout << "scored " << result.score << endl;
+			}
+		}
+	};
+}
+
+int runSearch ( int argc, char* argv[] )
+{
+	if ( argc < 2 )
+	{
+		cout << "[ERROR] Usage: search Agent Folder [Options]" << endl;
+		return 0;
+	}
+
+	string			agentName = argv[0];
+	string			folder    = argv[1];
+	SearchOptions	options;
+
+	for ( int index = 2; index < argc; ++index )
+	{
+		string token = argv[index];
+
+		if ( token == "--size" && index + 2 < argc )
+		{
+			options.minSize = atoi ( argv[++index] );
+			options.maxSize = atoi ( argv[++index] );
+		}
+		else if ( token == "--pits" && index + 1 < argc )
+			options.pitDensity = atof ( argv[++index] );
+		else if ( token == "--games" && index + 1 < argc )
+			options.games = strtoull ( argv[++index], NULL, 10 );
+		else if ( token == "--time" && index + 1 < argc )
+			options.seconds = max ( 0.0, atof ( argv[++index] ) );
+		else if ( token == "--below" && index + 1 < argc )
+			options.below = atoi ( argv[++index] );
+		else if ( token == "--regret" && index + 1 < argc )
+		{
+			options.useRegret = true;
+			options.regret    = atoi ( argv[++index] );
+		}
+		else if ( token == "--patience" && index + 1 < argc )
+			options.patience = max ( 1, atoi ( argv[++index] ) );
+		else if ( token == "--seed" && index + 1 < argc )
+			options.seed = strtoull ( argv[++index], NULL, 10 );
+		else if ( token == "--threads" && index + 1 < argc )
+			options.threads = max ( 1, atoi ( argv[++index] ) );
+		else if ( token == "--pin" )
+			options.pin = true;
+		else
+		{
+			cout << "[ERROR] Unknown search option " << token << "." << endl;
+			return 0;
+		}
+	}
+
+	// The start cell stays empty, so a board needs another cell
+	if ( options.minSize < 2 || options.maxSize > WorldDescription::MAX_DIMENSION || options.minSize > options.maxSize )
+	{
+		cout << "[ERROR] --size must be within 2.." << WorldDescription::MAX_DIMENSION << "." << endl;
+		return 0;
+	}
+
+	unique_ptr<Agent> probe ( AgentRegistry::make ( agentName ) );
+	if ( !probe )
+	{
+		cout << "[ERROR] Unknown agent " << agentName << "." << endl;
+		return 0;
+	}
+
+	mkdir ( folder.c_str(), 0777 );
+
+	struct sigaction handler = {}, previous[sizeof FATAL_SIGNALS / sizeof *FATAL_SIGNALS];
+	handler.sa_handler = onFatalSignal;
+	sigemptyset ( &handler.sa_mask );
+	for ( size_t i = 0; i < sizeof FATAL_SIGNALS / sizeof *FATAL_SIGNALS; ++i )
+		sigaction ( FATAL_SIGNALS[i], &handler, &previous[i] );
+
+	// Each worker climbs on its own with its own World, built on its
+	// thread after any pinning, and counts its games on its own cache
+	// line
+	struct alignas ( Affinity::CACHE_LINE ) Count
+	{
+		uint64_t played = 0;
+	};
+
+	Findings		findings;
+	vector<Count>	counts ( options.threads );
+	vector<thread>	workers;
+	bool			timed    = options.seconds > 0;
+	chrono::steady_clock::time_point started  = chrono::steady_clock::now();
+	chrono::steady_clock::time_point deadline = started + chrono::duration_cast<chrono::steady_clock::duration> (
+		chrono::duration<double> ( options.seconds ) );
+
+	Affinity::Placement placement;
+	if ( options.pin )
+		placement = Affinity::placement();
+
+	for ( int t = 0; t < options.threads; ++t )
+		workers.emplace_back ( [&, t]
+		{
+			if ( options.pin )
+				Affinity::pinWorker ( placement, t, options.threads );
+			uint64_t quota = options.games / options.threads + ( static_cast<uint64_t> ( t ) < options.games % options.threads );
+			if ( quota == 0 )
+				return;
+
+			Searcher searcher ( options, agentName, folder, findings, t );
+			counts[t].played = searcher.run ( quota, timed, deadline );
+		} );
+	for ( thread& worker : workers )
+		worker.join();
+
+	for ( size_t i = 0; i < sizeof FATAL_SIGNALS / sizeof *FATAL_SIGNALS; ++i )
+		sigaction ( FATAL_SIGNALS[i], &previous[i], NULL );
+
+	uint64_t played = 0;
+	for ( const Count& count : counts )
+		played += count.played;
+	double elapsed = chrono::duration<double> ( chrono::steady_clock::now() - started ).count();
+
+	cout << "Games: " << played << " in " << elapsed << " s ("
+		 << ( elapsed > 0 ? played / elapsed : 0 ) << " games/s)" << endl;
+	cout << "Boards saved to " << folder << ": " << findings.saved.size()
+		 << " (" << findings.crashes << " crashes, " << findings.failures << " failures)" << endl;
+	return 0;
+}
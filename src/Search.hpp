@@ -0,0 +1,75 @@
+// ======================================================================
+// FILE:        Search.hpp
+//
+// DESCRIPTION: This file contains the adversarial world search, which
+//              looks for boards an agent fails on. Each worker thread
+//              hill-climbs over boards: it edits the current board a
+//              little, plays the agent on it in-process, and keeps the
+//              edit if the agent did no better. Boards the agent fails
+//              on are saved as world files, ready to be used as a
+//              regression suite with -f, fingerprint or regret.
+//
+// NOTES:       - Syntax:
+//
+//                  Wumpus_World search Agent Folder [Options]
+//
+//                  Agent is an AgentRegistry name; failing boards are
+//                  written to Folder as search_<key>.txt, where <key> is
+//                  the board's WorldDescription::key() in hex.
+//
+//                  Options:
+//                      --size MIN MAX  Columns and rows of each new board
+//                                      are picked uniformly from MIN..MAX.
+//                                      Default 4 7.
+//                      --pits P        Chance of a pit on each cell of a
+//                                      new board. Default 0.2.
+//                      --games N       Games to play in all. Default
+//                                      100000.
+//                      --time SECONDS  Stop after SECONDS seconds even if
+//                                      games are left.
+//                      --below S       Save boards the agent scores below
+//                                      S on. Default -1000, so deaths and
+//                                      games that run out of points.
+//                      --regret R      Climb towards the agent's regret
+//                                      (see Solver.hpp) instead of its
+//                                      low scores, and save boards with a
+//                                      regret of at least R.
+//                      --patience N    Start over from a new board after
+//                                      N edits in a row bring no
+//                                      improvement. Default 200.
+//                      --seed S        Seed; with the same seed, options
+//                                      and thread count the search plays
+//                                      the same games unless --time cuts
+//                                      it short. Default 0.
+//                      --threads T     Worker threads. Default: one per
+//                                      usable CPU (see Affinity.hpp).
+//                      --pin           Pin each worker to its own CPU.
+//
+//              - An edit adds or removes a pit, moves a pit to a
+//                neighbouring cell, or moves the wumpus or the gold. The
+//                board is kept as a World::GameState, and an edit only
+//                touches the breeze or stench of the cells next to what
+//                moved, so a candidate costs a copy of the state and a
+//                few tile updates rather than a rebuild from a
+//                description. The start cell never holds anything.
+//
+//              - A game that throws counts as a crash and is saved at
+//                once. A game that brings the process down (a segfault,
+//                or an abort from a checked build, e.g. one with
+//                -D_GLIBCXX_ASSERTIONS) has its board written to
+//                search_crash_<worker>.txt in Folder before the process
+//                dies.
+//
+//              - Each game gets the seed -f --seed S would give the file
+//                its board is saved as, S being the search's seed, so a
+//                board saved for a non-deterministic agent fails the
+//                same way under -f --seed S.
+// ======================================================================
+
+#ifndef SEARCH_LOCK
+#define SEARCH_LOCK
+
+// Runs the search subcommand on the arguments that follow it
+int runSearch ( int argc, char* argv[] );
+
+#endif /* SEARCH_LOCK */
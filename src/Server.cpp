@@ -0,0 +1,533 @@
+// ======================================================================
+// FILE:        Server.cpp
+//
+// DESCRIPTION: This file contains the evaluation server, which runs
+//              jobs sent over a local Unix-domain socket.
+// ======================================================================
+
+#include "Server.hpp"
+#include "AgentRegistry.hpp"
+#include "Player.hpp"
+#include "Suite.hpp"
+#include "Hash.hpp"
+#include "Affinity.hpp"
+#include "Statistics.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+
+// ===============================================================
+// =						Jobs
+// ===============================================================
+
+// The most games a RUN may ask for
+const uint64_t MAX_JOB_GAMES = uint64_t ( 1 ) << 30;
+
+// A RUN command in progress. Workers claim its games a task at a time,
+// play them and stream the results to the client; the connection waits
+// for the last game.
+struct Job
+{
+	const Suite*	suite;
+	string			agent;
+	uint64_t		firstSeed;
+	size_t			games;			// Worlds times seeds
+	size_t			perTask;		// Games claimed at once
+	size_t			next = 0;		// First unclaimed game; guarded by the pool's lock
+	int				fd;				// The client
+
+	mutex				lock;
+	condition_variable	finished;
+	size_t				completed = 0;		// Games played, failed or skipped
+	size_t				failures  = 0;
+	RunningStats		stats;				// Scores of the games that did not fail
+
+	// The client went away; the games left are skipped. Read by the
+	// workers without the lock
+	atomic<bool>		broken { false };
+};
+
+// Writes all of 'text' to the socket; false if the peer is gone
+static bool sendAll ( int fd, const string& text )
+{
+	const char*	data      = text.data();
+	size_t		remaining = text.size();
+
+	while ( remaining > 0 )
+	{
+		ssize_t sent = ::send ( fd, data, remaining, MSG_NOSIGNAL );
+		if ( sent < 0 )
+		{
+			if ( errno == EINTR )
+				continue;
+			return false;
+		}
+		data      += sent;
+		remaining -= sent;
+	}
+	return true;
+}
+
+// ===============================================================
+// =					Worker Pool
+// ===============================================================
+
+class WorkerPool
+{
+public:
+
+	// With 'pin', worker t runs on the t-th usable CPU when there are
+	// enough
+	WorkerPool ( int threads, bool pin )
+	{
+		if ( pin )
+			placement = Affinity::placement();
+
+		for ( int t = 0; t < threads; ++t )
+			workers.emplace_back ( [this, t, threads, pin]
+			{
+				if ( pin )
+					Affinity::pinWorker ( placement, t, threads );
+				work();
+			} );
+	}
+
+	// Finishes the queued jobs, then stops the workers
+	~WorkerPool()
+	{
+		{
+			lock_guard<mutex> guard ( lock );
+			stopping = true;
+		}
+		ready.notify_all();
+		for ( thread& worker : workers )
+			worker.join();
+	}
+
+	size_t size ( void ) const { return workers.size(); }
+
+	// Queues a job; its games are claimed as workers come free
+	void submit ( shared_ptr<Job> job )
+	{
+		{
+			lock_guard<mutex> guard ( lock );
+			jobs.push_back ( move ( job ) );
+		}
+		ready.notify_all();
+	}
+
+private:
+
+	vector<thread>			workers;
+	Affinity::Placement		placement;
+	mutex					lock;
+	condition_variable		ready;
+	deque<shared_ptr<Job>>	jobs;			// Jobs with games left to claim
+	bool					stopping = false;
+
+	void work ( void )
+	{
+		// One warm Player per agent name, built on this worker's CPU
+		unordered_map<string, unique_ptr<Player>> players;
+		string results;
+
+		for ( ;; )
+		{
+			// Claim the next games of the job at the front, then move it
+			// to the back, so concurrent jobs take turns
+			shared_ptr<Job>	claimed;
+			size_t			begin, end;
+			{
+				unique_lock<mutex> guard ( lock );
+				ready.wait ( guard, [this] { return stopping || !jobs.empty(); } );
+				if ( jobs.empty() )
+					return;
+
+				claimed = move ( jobs.front() );
+				jobs.pop_front();
+				// The games of a job whose client went away are skipped,
+				// so they are claimed all at once
+				begin = claimed->next;
+				end   = claimed->broken ? claimed->games : min ( claimed->games, begin + claimed->perTask );
+				claimed->next = end;
+				if ( end < claimed->games )
+					jobs.push_back ( claimed );
+			}
+
+			Job&				job    = *claimed;
+			unique_ptr<Player>&	player = players[job.agent];
+			if ( !player )
+				player.reset ( new Player ( AgentRegistry::make ( job.agent ) ) );
+
+			RunningStats	stats;
+			size_t			failures = 0;
+			results.clear();
+
+			// Nobody is listening any more: count the games as done
+			// without playing them
+			size_t last = job.broken ? begin : end;
+
+			for ( size_t game = begin; game < last; ++game )
+			{
+				size_t					index = game % job.suite->worlds.size();
+				uint64_t				seed  = job.firstSeed + game / job.suite->worlds.size();
+				const string&			name  = job.suite->names[index];
+				const WorldDescription&	world = job.suite->worlds[index];
+
+				// Seeded like the Evaluator with --seed
+				uint64_t gameSeed = Hash::fnv1a ( name, seed );
+
+				int score;
+				try
+				{
+					score = player->play ( world, gameSeed );
+				}
+				catch (...)
+				{
+					++failures;
+					results.append ( "FAILED " ).append ( to_string ( seed ) ).append ( " " ).append ( name ).append ( "\n" );
+					continue;
+				}
+
+				stats.add ( score );
+				results.append ( "RESULT " ).append ( to_string ( seed ) ).append ( " " ).append ( name )
+					   .append ( " " ).append ( to_string ( score ) ).append ( "\n" );
+			}
+
+			// One write per task keeps the lines whole and the lock short
+			lock_guard<mutex> guard ( job.lock );
+			if ( !job.broken && !sendAll ( job.fd, results ) )
+				job.broken = true;
+			job.stats.merge ( stats );
+			job.failures  += failures;
+			job.completed += end - begin;
+			if ( job.completed == job.games )
+				job.finished.notify_all();
+		}
+	}
+};
+
+// ===============================================================
+// =						Server
+// ===============================================================
+
+class Server
+{
+public:
+
+	Server ( const map<string, Suite>& _suites, int threads, bool pin )
+		: suites ( _suites ), pool ( threads, pin ), listener ( -1 ), stopping ( false )
+	{
+	}
+
+	~Server()
+	{
+		if ( listener >= 0 )
+			close ( listener );
+	}
+
+	bool listen ( const string& path )
+	{
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		if ( path.size() >= sizeof address.sun_path )
+		{
+			cout << "[ERROR] Socket path is too long." << endl;
+			return false;
+		}
+		strcpy ( address.sun_path, path.c_str() );
+
+		// A socket left behind by an earlier server is replaced; any
+		// other kind of file is not
+		struct stat info;
+		if ( stat ( path.c_str(), &info ) == 0 )
+		{
+			if ( !S_ISSOCK ( info.st_mode ) )
+			{
+				cout << "[ERROR] " << path << " exists and is not a socket." << endl;
+				return false;
+			}
+			unlink ( path.c_str() );
+		}
+
+		listener = socket ( AF_UNIX, SOCK_STREAM, 0 );
+		if ( listener < 0
+				|| bind ( listener, reinterpret_cast<sockaddr*> ( &address ), sizeof address ) != 0
+				|| ::listen ( listener, 64 ) != 0 )
+		{
+			cout << "[ERROR] Failed to listen on " << path << ": " << strerror ( errno ) << "." << endl;
+			return false;
+		}
+		return true;
+	}
+
+	// Accepts connections until a client sends SHUTDOWN
+	void serve ( void )
+	{
+		while ( !stopping )
+		{
+			int client = accept ( listener, NULL, NULL );
+			if ( client < 0 )
+			{
+				if ( errno == EINTR || errno == ECONNABORTED )
+					continue;
+				break;
+			}
+
+			// Join the connections that ended since the last accept, so a
+			// long-running server does not collect finished threads
+			vector<thread> ended;
+			{
+				lock_guard<mutex> guard ( lock );
+				for ( thread::id id : finished )
+				{
+					auto found = connections.find ( id );
+					ended.push_back ( move ( found->second ) );
+					connections.erase ( found );
+				}
+				finished.clear();
+
+				if ( stopping )
+				{
+					close ( client );
+					break;
+				}
+				clients.push_back ( client );
+
+				thread connection ( [this, client] { converse ( client ); } );
+				connections.emplace ( connection.get_id(), move ( connection ) );
+			}
+			for ( thread& connection : ended )
+				connection.join();
+		}
+
+		// Wake every connection still waiting for a command, then wait
+		// for them to finish their jobs
+		map<thread::id, thread> remaining;
+		{
+			lock_guard<mutex> guard ( lock );
+			for ( int client : clients )
+				shutdown ( client, SHUT_RD );
+			remaining.swap ( connections );
+			finished.clear();
+		}
+		for ( auto& connection : remaining )
+			connection.second.join();
+	}
+
+private:
+
+	const map<string, Suite>&	suites;
+	WorkerPool					pool;
+	int							listener;
+	atomic<bool>				stopping;
+
+	mutex						lock;			// Guards the three below
+	vector<int>					clients;
+	map<thread::id, thread>		connections;	// Connection threads not yet joined
+	vector<thread::id>			finished;		// Those done with their client
+
+	void converse ( int client )
+	{
+		string	buffer;
+		char	chunk[4096];
+
+		for ( ;; )
+		{
+			size_t end = buffer.find ( '\n' );
+			if ( end == string::npos )
+			{
+				ssize_t received = recv ( client, chunk, sizeof chunk, 0 );
+				if ( received < 0 && errno == EINTR )
+					continue;
+				if ( received <= 0 )
+					break;
+				buffer.append ( chunk, received );
+				continue;
+			}
+
+			string line = buffer.substr ( 0, end );
+			buffer.erase ( 0, end + 1 );
+			if ( !line.empty() && line.back() == '\r' )
+				line.pop_back();
+
+			if ( !command ( client, line ) )
+				break;
+		}
+
+		// serve() joins the thread on its next accept, or at shutdown
+		lock_guard<mutex> guard ( lock );
+		clients.erase ( find ( clients.begin(), clients.end(), client ) );
+		close ( client );
+		finished.push_back ( this_thread::get_id() );
+	}
+
+	// Runs one command; false to close the connection
+	bool command ( int client, const string& line )
+	{
+		istringstream	in ( line );
+		string			verb;
+		in >> verb;
+
+		if ( verb == "RUN" )
+		{
+			string		agent, suite;
+			uint64_t	firstSeed, lastSeed;
+			if ( !( in >> agent >> suite >> firstSeed ) )
+				return sendAll ( client, "ERROR Usage: RUN Agent Suite FirstSeed [LastSeed]\n" );
+			if ( !( in >> lastSeed ) )
+				lastSeed = firstSeed;
+			return run ( client, agent, suite, firstSeed, lastSeed );
+		}
+
+		if ( verb == "SUITES" )
+		{
+			string reply;
+			for ( const auto& suite : suites )
+				reply += "SUITE " + suite.first + " " + to_string ( suite.second.worlds.size() ) + "\n";
+			return sendAll ( client, reply + "OK\n" );
+		}
+
+		if ( verb == "AGENTS" )
+		{
+			string reply;
+			for ( const string& name : AgentRegistry::names() )
+				reply += "AGENT " + name + "\n";
+			return sendAll ( client, reply + "OK\n" );
+		}
+
+		if ( verb == "QUIT" )
+			return false;
+
+		if ( verb == "SHUTDOWN" )
+		{
+			stopping = true;
+			shutdown ( listener, SHUT_RDWR );
+			return false;
+		}
+
+		if ( verb.empty() )
+			return true;
+
+		return sendAll ( client, "ERROR Unknown command " + verb + "\n" );
+	}
+
+	bool run ( int client, const string& agent, const string& suiteName, uint64_t firstSeed, uint64_t lastSeed )
+	{
+		auto found = suites.find ( suiteName );
+		if ( found == suites.end() )
+			return sendAll ( client, "ERROR Unknown suite " + suiteName + "\n" );
+
+		unique_ptr<Agent> probe ( AgentRegistry::make ( agent ) );
+		if ( !probe )
+			return sendAll ( client, "ERROR Unknown agent " + agent + "\n" );
+
+		if ( lastSeed < firstSeed )
+			return sendAll ( client, "ERROR LastSeed is below FirstSeed\n" );
+
+		// Seeds times worlds, checked without computing the product,
+		// which may not fit
+		uint64_t worlds = found->second.worlds.size();
+		if ( lastSeed - firstSeed >= MAX_JOB_GAMES / worlds )
+			return sendAll ( client, "ERROR A job may play at most " + to_string ( MAX_JOB_GAMES ) + " games\n" );
+
+		shared_ptr<Job> job = make_shared<Job>();
+		job->suite     = &found->second;
+		job->agent     = agent;
+		job->firstSeed = firstSeed;
+		job->games     = worlds * ( lastSeed - firstSeed + 1 );
+		job->fd        = client;
+
+		// Enough tasks to keep every worker busy, few enough that a task
+		// costs little next to its games
+		job->perTask = max<size_t> ( 1, min<size_t> ( 256, job->games / ( 4 * pool.size() ) ) );
+		pool.submit ( job );
+
+		unique_lock<mutex> guard ( job->lock );
+		job->finished.wait ( guard, [&] { return job->completed == job->games; } );
+		if ( job->broken )
+			return false;
+
+		ostringstream done;
+		done.precision ( 17 );
+		done << "DONE " << job->games << " " << job->failures << " " << job->stats.mean << " " << job->stats.stdev() << "\n";
+		return sendAll ( client, done.str() );
+	}
+};
+
+int runServer ( int argc, char* argv[] )
+{
+	if ( argc < 1 )
+	{
+		cout << "Wumpus_World serve SocketPath --suite NAME PATH [--suite NAME PATH ...] [--threads T] [--pin]" << endl;
+		return 0;
+	}
+
+	string				path    = argv[0];
+	int					threads = Affinity::defaultThreads();
+	bool				pin     = false;
+	map<string, Suite>	suites;
+
+	for ( int index = 1; index < argc; ++index )
+	{
+		string token = argv[index];
+
+		if ( token == "--suite" && index + 2 < argc )
+		{
+			string name = argv[++index];
+			string from = argv[++index];
+			if ( !loadSuite ( from, suites[name] ) || suites[name].worlds.empty() )
+			{
+				cout << "[ERROR] Failed to load suite " << name << " from " << from << "." << endl;
+				return 0;
+			}
+		}
+		else if ( token == "--threads" && index + 1 < argc )
+			threads = max ( 1, atoi ( argv[++index] ) );
+		else if ( token == "--pin" )
+			pin = true;
+		else
+		{
+			cout << "[ERROR] Unknown serve option " << token << "." << endl;
+			return 0;
+		}
+	}
+
+	if ( suites.empty() )
+	{
+		cout << "[ERROR] No suites to serve." << endl;
+		return 0;
+	}
+
+	Server server ( suites, threads, pin );
+	if ( !server.listen ( path ) )
+		return 0;
+
+	for ( const auto& suite : suites )
+		cout << "Serving suite " << suite.first << " (" << suite.second.worlds.size() << " worlds)" << endl;
+	cout << "Listening on " << path << " with " << threads << " workers" << endl;
+
+	server.serve();
+	unlink ( path.c_str() );
+	return 0;
+}
@@ -0,0 +1,59 @@
+// ======================================================================
+// FILE:        Server.hpp
+//
+// DESCRIPTION: This file contains the evaluation server, which keeps
+//              world suites and a pool of worker threads in memory and
+//              runs jobs sent over a local Unix-domain socket. A job
+//              costs a round trip instead of a process start and a
+//              folder scan.
+//
+// NOTES:       - Syntax:
+//
+//                  Wumpus_World serve SocketPath --suite NAME PATH
+//                                     [--suite NAME PATH ...]
+//                                     [--threads T] [--pin]
+//
+//                  PATH is a folder of Wumpus World Files or a packed
+//                  suite file (see Generator.hpp). Worlds are played in
+//                  file name order; world k of a packed suite is named
+//                  <pack>/world_<k> (see Suite.hpp). T defaults to
+//                  one worker per usable CPU, and --pin pins each worker
+//                  to its own CPU (see Affinity.hpp).
+//
+//              - Protocol: one command per line, answered by lines that
+//                start with a keyword. A connection may send any number
+//                of commands, one at a time.
+//
+//                  RUN Agent Suite FirstSeed [LastSeed]
+//                      Plays every world of the suite once for each seed
+//                      from FirstSeed to LastSeed (default FirstSeed).
+//                      Answers one line per game as it finishes, in no
+//                      particular order,
+//                          RESULT Seed World Score
+//                      or FAILED Seed World if the agent threw, then
+//                          DONE Games Failures Mean Stdev
+//                      A game is seeded exactly like -f --seed Seed, so
+//                      the scores match the command line.
+//                      A job may play at most 2^30 games.
+//
+//                  SUITES  Answers SUITE Name Worlds per suite, then OK.
+//                  AGENTS  Answers AGENT Name per agent, then OK.
+//                  QUIT    Closes the connection.
+//                  SHUTDOWN
+//                          Finishes the running jobs and stops the
+//                          server.
+//
+//                  A malformed command is answered with ERROR Message.
+//
+//              - Agents are looked up in AgentRegistry. Each worker keeps
+//                one Player per agent name (see Player.hpp), so a warm
+//                server does not allocate per game.
+// ======================================================================
+
+#ifndef SERVER_LOCK
+#define SERVER_LOCK
+
+// Runs the serve subcommand on the arguments that follow it
+int runServer ( int argc, char* argv[] );
+
+#endif /* SERVER_LOCK */
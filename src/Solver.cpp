@@ -0,0 +1,311 @@
+// ======================================================================
+// FILE:        Solver.cpp
+//
+// DESCRIPTION: This file contains the omniscient solver and the regret
+//              mode, which measures how far an agent is from optimal.
+// ======================================================================
+
+#include "Solver.hpp"
+#include "AgentRegistry.hpp"
+#include "Player.hpp"
+#include "Suite.hpp"
+#include "Compass.hpp"
+#include "Hash.hpp"
+#include "Affinity.hpp"
+#include "Analytics.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <climits>
+#include <cstdlib>
+
+using namespace std;
+
+// ===============================================================
+// =						Solver
+// ===============================================================
+
+namespace
+{
+	const int MAX = WorldDescription::MAX_DIMENSION;
+
+	// A state packed as ((((x * MAX + y) * 4 + dir) * 2 + arrow) * 2 + gold) * 2 + alive
+	const int STATES = MAX * MAX * 4 * 2 * 2 * 2;
+
+	int pack ( int x, int y, int dir, int arrow, int gold, int alive )
+	{
+		return ( ( ( ( x * MAX + y ) * 4 + dir ) * 2 + arrow ) * 2 + gold ) * 2 + alive;
+	}
+}
+
+int optimalScore ( const WorldDescription& description )
+{
+	bool pit[MAX][MAX] = {};
+	for ( const WorldDescription::Cell& cell : description.pits )
+		if ( description.isInBounds ( cell.c, cell.r ) )
+			pit[cell.c][cell.r] = true;
+
+	int		wx = description.wumpus.c, wy = description.wumpus.r;
+	int		gx = description.gold.c,   gy = description.gold.r;
+	bool	hasWumpus = description.isInBounds ( wx, wy );
+
+	vector<int> distance ( STATES, INT_MAX );
+	priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> frontier;
+
+	auto relax = [&] ( int state, int cost )
+	{
+		if ( cost < distance[state] )
+		{
+			distance[state] = cost;
+			frontier.emplace ( cost, state );
+		}
+	};
+
+	relax ( pack ( 0, 0, Compass::RIGHT, 1, 0, hasWumpus ), 0 );
+
+	while ( !frontier.empty() )
+	{
+		int cost  = frontier.top().first;
+		int state = frontier.top().second;
+		frontier.pop();
+		if ( cost > distance[state] )
+			continue;
+
+		int alive = state & 1;
+		int gold  = state >> 1 & 1;
+		int arrow = state >> 2 & 1;
+		int dir   = state >> 3 & 3;
+		int y     = ( state >> 5 ) % MAX;
+		int x     = ( state >> 5 ) / MAX;
+
+		// The first time the start is reached with the gold is the
+		// cheapest, and climbing costs one more action
+		if ( gold && x == 0 && y == 0 )
+			return max ( -1, 1000 - cost - 1 );
+
+		relax ( pack ( x, y, Compass::LEFT_OF[dir],  arrow, gold, alive ), cost + 1 );
+		relax ( pack ( x, y, Compass::RIGHT_OF[dir], arrow, gold, alive ), cost + 1 );
+
+		int nx = x + Compass::DX[dir];
+		int ny = y + Compass::DY[dir];
+		if ( description.isInBounds ( nx, ny ) && !pit[nx][ny] && !( alive && nx == wx && ny == wy ) )
+			relax ( pack ( nx, ny, dir, arrow, gold, alive ), cost + 1 );
+
+		if ( !gold && x == gx && y == gy )
+			relax ( pack ( x, y, dir, arrow, 1, alive ), cost + 1 );
+
+		if ( arrow )
+		{
+			// The arrow flies from the agent's cell to the wall
+			int killed = 0;
+			for ( int ax = x, ay = y; description.isInBounds ( ax, ay ); ax += Compass::DX[dir], ay += Compass::DY[dir] )
+				if ( alive && ax == wx && ay == wy )
+					killed = 1;
+			relax ( pack ( x, y, dir, 0, gold, alive && !killed ), cost + 11 );
+		}
+	}
+
+	// The gold cannot be brought back
+	return -1;
+}
+
+// ===============================================================
+// =						Regret
+// ===============================================================
+
+struct RegretOptions
+{
+	uint64_t	seed    = 0;
+	int			threads = Affinity::defaultThreads();
+	bool		pin     = false;
+	size_t		worst   = 10;
+	string		output;
+	string		analytics;
+};
+
+// What one world produced
+struct WorldRegret
+{
+	int		optimal = 0;
+	int		score   = 0;
+	bool	failed  = false;	// The agent threw
+};
+
+int runRegret ( int argc, char* argv[] )
+{
+	if ( argc < 2 )
+	{
+		cout << "[ERROR] Usage: regret Agent Suite [Options]" << endl;
+		return 0;
+	}
+
+	string			agentName = argv[0];
+	string			path      = argv[1];
+	RegretOptions	options;
+
+	for ( int index = 2; index < argc; ++index )
+	{
+		string token = argv[index];
+
+		if ( token == "--seed" && index + 1 < argc )
+			options.seed = strtoull ( argv[++index], NULL, 10 );
+		else if ( token == "--threads" && index + 1 < argc )
+			options.threads = max ( 1, atoi ( argv[++index] ) );
+		else if ( token == "--pin" )
+			options.pin = true;
+		else if ( token == "--worst" && index + 1 < argc )
+			options.worst = strtoul ( argv[++index], NULL, 10 );
+		else if ( token == "--write" && index + 1 < argc )
+			options.output = argv[++index];
+		else if ( token == "--analytics" && index + 1 < argc )
+			options.analytics = argv[++index];
+		else
+		{
+			cout << "[ERROR] Unknown regret option " << token << "." << endl;
+			return 0;
+		}
+	}
+
+	unique_ptr<Agent> probe ( AgentRegistry::make ( agentName ) );
+	if ( !probe )
+	{
+		cout << "[ERROR] Unknown agent " << agentName << "." << endl;
+		return 0;
+	}
+
+	Suite suite;
+	if ( !loadSuite ( path, suite ) || suite.worlds.empty() )
+	{
+		cout << "[ERROR] Failed to load suite " << path << "." << endl;
+		return 0;
+	}
+
+	// Workers take blocks of worlds from a shared counter, so no two
+	// write results on the same cache line; each has its own Player and
+	// SpatialStats, built on its thread after any pinning, and only takes
+	// the lock to merge its counts once it is done
+	const size_t		BLOCK = 64;
+	bool				recording = !options.analytics.empty();
+	vector<WorldRegret>	results ( suite.worlds.size() );
+	SpatialStats		spatial;
+	mutex				spatialLock;
+	atomic<size_t>		next ( 0 );
+	vector<thread>		workers;
+	Affinity::Placement	placement;
+	if ( options.pin )
+		placement = Affinity::placement();
+	for ( int t = 0; t < options.threads; ++t )
+		workers.emplace_back ( [&, t]
+		{
+			if ( options.pin )
+				Affinity::pinWorker ( placement, t, options.threads );
+			Player player ( AgentRegistry::make ( agentName ) );
+			unique_ptr<SpatialStats> local;
+			if ( recording )
+			{
+				local.reset ( new SpatialStats );
+				player.setAnalytics ( local.get() );
+			}
+
+			for ( size_t first; ( first = next.fetch_add ( BLOCK ) ) < suite.worlds.size(); )
+			{
+				size_t last = min ( first + BLOCK, suite.worlds.size() );
+				for ( size_t i = first; i < last; ++i )
+				{
+					results[i].optimal = optimalScore ( suite.worlds[i] );
+					try
+					{
+						results[i].score = player.play ( suite.worlds[i], Hash::fnv1a ( suite.names[i], options.seed ) );
+					}
+					catch (...)
+					{
+						results[i].failed = true;
+					}
+				}
+			}
+
+			if ( local )
+			{
+				lock_guard<mutex> lock ( spatialLock );
+				spatial.merge ( *local );
+			}
+		} );
+	for ( thread& worker : workers )
+		worker.join();
+
+	if ( recording )
+	{
+		ofstream analytics ( options.analytics );
+		spatial.write ( analytics );
+		if ( !analytics )
+			cout << "[WARNING] Failed to write analytics file " << options.analytics << "." << endl;
+	}
+
+	ofstream file;
+	if ( !options.output.empty() )
+		file.open ( options.output );
+
+	double			optimalSum = 0, scoreSum = 0;
+	size_t			played = 0, optimalGames = 0;
+	vector<size_t>	order;
+	for ( size_t i = 0; i < results.size(); ++i )
+	{
+		if ( results[i].failed )
+		{
+			cout << "[WARNING] " << suite.names[i] << " failed; leaving it out." << endl;
+			continue;
+		}
+
+		++played;
+		optimalSum += results[i].optimal;
+		scoreSum   += results[i].score;
+		if ( results[i].score >= results[i].optimal )
+			++optimalGames;
+		order.push_back ( i );
+
+		if ( file.is_open() )
+			file << suite.names[i] << " " << results[i].optimal << " " << results[i].score << " "
+				 << results[i].optimal - results[i].score << "\n";
+	}
+
+	if ( played == 0 )
+	{
+		cout << "[ERROR] Every world failed." << endl;
+		return 0;
+	}
+
+	// Most regret first, ties by name so the list is stable
+	sort ( order.begin(), order.end(), [&] ( size_t a, size_t b )
+	{
+		int regretA = results[a].optimal - results[a].score;
+		int regretB = results[b].optimal - results[b].score;
+		return regretA != regretB ? regretA > regretB : suite.names[a] < suite.names[b];
+	} );
+
+	cout << "Worlds: " << played << endl;
+	cout << "Optimal average score: " << optimalSum / played << endl;
+	cout << agentName << " average score: " << scoreSum / played << endl;
+	cout << "Average regret: " << ( optimalSum - scoreSum ) / played << endl;
+	cout << "Played optimally: " << optimalGames << " of " << played << endl;
+
+	if ( options.worst > 0 )
+	{
+		cout << "Worst worlds:" << endl;
+		for ( size_t k = 0; k < order.size() && k < options.worst; ++k )
+		{
+			const WorldRegret& result = results[order[k]];
+			cout << "\t" << suite.names[order[k]] << ": regret " << result.optimal - result.score
+				 << " (optimal " << result.optimal << ", scored " << result.score << ")" << endl;
+		}
+	}
+	return 0;
+}
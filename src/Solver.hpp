@@ -0,0 +1,55 @@
+// ======================================================================
+// FILE:        Solver.hpp
+//
+// DESCRIPTION: This file contains the omniscient solver, which computes
+//              the best score any agent could get on a board if it knew
+//              the whole board, and the regret mode, which compares an
+//              agent's scores with those bounds across a suite.
+//
+// NOTES:       - The solver runs Dijkstra's algorithm on action cost
+//                over the states (cell, facing, arrow, gold, wumpus
+//                alive), at most 10 x 10 x 4 x 2 x 2 x 2 of them, under
+//                the World's rules: every action costs 1, a shot 10 more,
+//                and climbing out at the start with the gold earns 1000.
+//                Moves into a pit or a live wumpus are never taken. The
+//                optimal score is the better of climbing out at once (-1)
+//                and the cheapest way back to the start with the gold.
+//
+//              - Syntax:
+//
+//                  Wumpus_World regret Agent Suite [Options]
+//
+//                  Agent is an AgentRegistry name; Suite is a folder or a
+//                  packed suite file (see Suite.hpp).
+//
+//                  Options:
+//                      --seed S        Seed; each world's game is seeded
+//                                      as by -f --seed S. Default 0.
+//                      --threads T     Worker threads. Default: one per
+//                                      usable CPU (see Affinity.hpp).
+//                      --pin           Pin each worker to its own CPU.
+//                      --worst N       List the N worlds with the most
+//                                      regret. Default 10.
+//                      --write PATH    Write every world's optimal
+//                                      score, agent score and regret to
+//                                      PATH, one line per world.
+//                      --analytics PATH
+//                                      Write the agent's per-cell visit,
+//                                      death, bump and wasted-arrow
+//                                      counts to PATH (see Analytics.hpp).
+//                                      Each worker counts into its own
+//                                      SpatialStats, merged at the end.
+// ======================================================================
+
+#ifndef SOLVER_LOCK
+#define SOLVER_LOCK
+
+#include "WorldDescription.hpp"
+
+// The best score an agent that sees the whole board can get
+int optimalScore ( const WorldDescription& description );
+
+// Runs the regret subcommand on the arguments that follow it
+int runRegret ( int argc, char* argv[] );
+
+#endif /* SOLVER_LOCK */
@@ -0,0 +1,77 @@
+// ======================================================================
+// FILE:        Statistics.cpp
+//
+// DESCRIPTION: This file contains RunningStats, the streaming score
+//              statistics of a folder run.
+// ======================================================================
+
+#include "Statistics.hpp"
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+using namespace std;
+
+void RunningStats::add ( double score )
+{
+	++count;
+	double delta = score - mean;
+	mean += delta / count;
+	m2   += delta * ( score - mean );
+}
+
+void RunningStats::merge ( const RunningStats& other )
+{
+	if ( other.count == 0 )
+		return;
+	if ( count == 0 )
+	{
+		*this = other;
+		return;
+	}
+
+	uint64_t	total = count + other.count;
+	double		delta = other.mean - mean;
+
+	mean += delta * other.count / total;
+	m2   += other.m2 + delta * delta * ( (double) count * other.count / total );
+	count = total;
+}
+
+double RunningStats::stdev ( void ) const
+{
+	return sqrt ( variance() );
+}
+
+void RunningStats::write ( ostream& out ) const
+{
+	out << "SCORE: " << mean << '\n';
+	out << "STDEV: " << stdev() << '\n';
+
+	streamsize precision = out.precision ( numeric_limits<double>::max_digits10 );
+	out << "COUNT: " << count << '\n';
+	out << "MEAN: "  << mean  << '\n';
+	out << "M2: "    << m2    << '\n';
+	out.precision ( precision );
+}
+
+bool RunningStats::read ( istream& in )
+{
+	bool	haveCount = false, haveMean = false, haveM2 = false;
+	string	key;
+
+	*this = RunningStats();
+	while ( in >> key )
+	{
+		if ( key == "COUNT:" )
+			haveCount = bool ( in >> count );
+		else if ( key == "MEAN:" )
+			haveMean = bool ( in >> mean );
+		else if ( key == "M2:" )
+			haveM2 = bool ( in >> m2 );
+		else
+			in.ignore ( numeric_limits<streamsize>::max(), '\n' );
+	}
+	return haveCount && haveMean && haveM2;
+}
@@ -0,0 +1,50 @@
+// ======================================================================
+// FILE:        Statistics.hpp
+//
+// DESCRIPTION: This file contains RunningStats, the streaming score
+//              statistics of a folder run. Scores are accumulated with
+//              Welford's algorithm as a count, a mean and M2 (the sum of
+//              squared deviations from the mean), which can be merged
+//              exactly across shards with Chan's parallel formula.
+//
+// NOTES:       - The statistics file format is a superset of the -f
+//                output file:
+//
+//                  SCORE: <mean>
+//                  STDEV: <population standard deviation>
+//                  COUNT: <number of scores>
+//                  MEAN: <mean, full precision>
+//                  M2: <sum of squared deviations, full precision>
+//
+//                Only COUNT, MEAN and M2 are read back; the first two
+//                lines keep the file readable by existing tooling.
+// ======================================================================
+
+#ifndef STATISTICS_LOCK
+#define STATISTICS_LOCK
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+struct RunningStats
+{
+	uint64_t	count = 0;
+	double		mean  = 0;
+	double		m2    = 0;
+
+	void	add			( double score );
+	void	merge		( const RunningStats& other );
+	void	reset		( void ) { *this = RunningStats(); }
+
+	double	sum			( void ) const { return mean * count; }
+	double	variance	( void ) const { return count ? m2 / count : 0; }
+	double	stdev		( void ) const;
+
+	// Write or read the statistics file format; read() returns false if
+	// COUNT, MEAN or M2 is missing
+	void	write		( std::ostream& out ) const;
+	bool	read		( std::istream& in );
+};
+
+#endif /* STATISTICS_LOCK */
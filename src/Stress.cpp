@@ -0,0 +1,185 @@
+// ======================================================================
+// FILE:        Stress.cpp
+//
+// DESCRIPTION: This file contains the stress test, which checks that
+//              games played concurrently match games played alone.
+// ======================================================================
+
+#include "Stress.hpp"
+#include "World.hpp"
+#include "AgentRegistry.hpp"
+#include "Interleave.hpp"
+#include "Hash.hpp"
+#include "Affinity.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
+
+using namespace std;
+
+struct StressOptions
+{
+	size_t		games   = 10000;
+	uint64_t	seed    = 0;
+	int			threads = Affinity::defaultThreads();
+};
+
+// What one game produced
+struct GameResult
+{
+	int			score  = 0;
+	uint64_t	frames = 0;		// Hash of the debug display
+	bool		failed = false;	// The game threw
+};
+
+static GameResult playGame ( const StressOptions& options, size_t index, bool randomAI )
+{
+	GameResult	result;
+	uint64_t	seed = Hash::fnv1a ( &index, sizeof index, options.seed );
+
+	try
+	{
+		// Tail mode never waits, so the input stream is never read
+		ostringstream	out;
+		istringstream	in;
+		World			world ( true, randomAI, false, "", seed );
+		world.setRenderer ( FrameRenderer ( out, in, 0, 1 ) );
+
+		result.score  = world.run();
+		result.frames = Hash::fnv1a ( out.str() );
+	}
+	catch (...)
+	{
+		result.failed = true;
+	}
+	return result;
+}
+
+// The board of stress world 'index', as the World draws it
+static WorldDescription describeWorld ( const StressOptions& options, size_t index )
+{
+	World					world ( false, false, false, "", Hash::fnv1a ( &index, sizeof index, options.seed ) );
+	const World::GameState&	game = world.state();
+	WorldDescription		description;
+
+	description.colDimension = game.colDimension;
+	description.rowDimension = game.rowDimension;
+	for ( int c = 0; c < description.colDimension; ++c )
+		for ( int r = 0; r < description.rowDimension; ++r )
+		{
+			const World::Tile& tile = game.board[c][r];
+			if ( tile.pit )
+				description.pits.push_back ( { c, r } );
+			if ( tile.wumpus )
+				description.wumpus = { c, r };
+			if ( tile.gold )
+				description.gold = { c, r };
+		}
+	return description;
+}
+
+// Plays every world interleaved and one by one with each registered
+// agent; returns the worlds whose scores differ
+static size_t checkInterleaved ( const StressOptions& options )
+{
+	vector<WorldDescription> worlds;
+	for ( size_t i = 0; i < options.games; ++i )
+		worlds.push_back ( describeWorld ( options, i ) );
+
+	size_t mismatches = 0;
+	for ( const string& name : AgentRegistry::names() )
+	{
+		vector<int> interleaved;
+		if ( !playInterleaved ( worlds, [&] { return AgentRegistry::make ( name ); }, interleaved ) )
+		{
+			cout << "[WARNING] The stress worlds have no FixedWorld; skipping the interleaved check." << endl;
+			return 0;
+		}
+
+		for ( size_t i = 0; i < worlds.size(); ++i )
+		{
+			World world ( worlds[i], AgentRegistry::make ( name ) );
+			int alone = world.run();
+			if ( alone != interleaved[i] )
+			{
+				if ( mismatches == 0 )
+					cout << "First interleaved mismatch: world " << i << " with " << name << " scored "
+						 << alone << " alone and " << interleaved[i] << " interleaved." << endl;
+				++mismatches;
+			}
+		}
+	}
+
+	cout << "Interleaved " << worlds.size() << " games for each of " << AgentRegistry::names().size()
+		 << " agents: " << mismatches << " mismatches." << endl;
+	return mismatches;
+}
+
+int runStress ( int argc, char* argv[] )
+{
+	StressOptions options;
+
+	int index = 0;
+	if ( index < argc && argv[index][0] != '-' )
+		options.games = strtoul ( argv[index++], NULL, 10 );
+
+	for ( ; index < argc; ++index )
+	{
+		string token = argv[index];
+
+		if ( token == "--seed" && index + 1 < argc )
+			options.seed = strtoull ( argv[++index], NULL, 10 );
+		else if ( token == "--threads" && index + 1 < argc )
+			options.threads = max ( 1, atoi ( argv[++index] ) );
+		else
+		{
+			cout << "[ERROR] Unknown stress option " << token << "." << endl;
+			return 0;
+		}
+	}
+
+	// Game 2i is MyAI on world i, game 2i+1 the RandomAI on it
+	size_t				total = 2 * options.games;
+	vector<GameResult>	alone ( total ), together ( total );
+
+	for ( size_t i = 0; i < total; ++i )
+		alone[i] = playGame ( options, i / 2, i % 2 );
+
+	// Thread t plays games t, t + T, t + 2T, ..., so neighbouring games,
+	// which share a world, run at the same time
+	vector<thread> workers;
+	for ( int t = 0; t < options.threads; ++t )
+		workers.emplace_back ( [&, t]
+		{
+			for ( size_t i = t; i < total; i += options.threads )
+				together[i] = playGame ( options, i / 2, i % 2 );
+		} );
+	for ( thread& worker : workers )
+		worker.join();
+
+	size_t mismatches = 0, failures = 0;
+	for ( size_t i = 0; i < total; ++i )
+	{
+		if ( alone[i].failed || together[i].failed )
+			++failures;
+		else if ( alone[i].score != together[i].score || alone[i].frames != together[i].frames )
+		{
+			if ( mismatches == 0 )
+				cout << "First mismatch: world " << i / 2 << " with " << ( i % 2 ? "RandomAI" : "MyAI" )
+					 << " scored " << alone[i].score << " alone and " << together[i].score << " concurrently." << endl;
+			++mismatches;
+		}
+	}
+
+	cout << "Played " << total << " games on " << options.threads << " threads: "
+		 << mismatches << " mismatches, " << failures << " failures." << endl;
+
+	mismatches += checkInterleaved ( options );
+	return mismatches == 0 && failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+// ======================================================================
+// FILE:        Stress.hpp
+//
+// DESCRIPTION: This file contains the stress test, which plays many
+//              games at once on many threads and checks that every game
+//              matches the same game played alone. It guards the
+//              engine's promise that Worlds share no mutable state, and
+//              that games interleaved on one thread do not affect each
+//              other either.
+//
+// NOTES:       - Syntax:
+//
+//                  Wumpus_World stress [Games] [Options]
+//
+//                  Options:
+//                      --seed S        Seed; game i is seeded by (S, i).
+//                                      Default 0.
+//                      --threads T     Worker threads. Default: one per
+//                                      usable CPU (see Affinity.hpp).
+//
+//              - Every game is a random world played by MyAI and again
+//                by the RandomAI, with the debug display drawn into a
+//                string stream. A game matches if the score and a hash
+//                of the display are the same on both runs. Games
+//                defaults to 10000.
+//
+//              - Every registered agent (see AgentRegistry.hpp) then
+//                plays the same worlds interleaved on one thread, one
+//                turn of each game in turn (see Interleave.hpp), and
+//                again one game after another; a world matches if both
+//                scores are the same.
+//
+//              - Exits with status 1 if any game differs. Build with
+//                -fsanitize=thread to also check for data races.
+// ======================================================================
+
+#ifndef STRESS_LOCK
+#define STRESS_LOCK
+
+// Runs the stress subcommand on the arguments that follow it
+int runStress ( int argc, char* argv[] );
+
+#endif /* STRESS_LOCK */
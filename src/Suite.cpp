@@ -0,0 +1,80 @@
+// ======================================================================
+// FILE:        Suite.cpp
+//
+// DESCRIPTION: This file contains Suite, a named list of worlds loaded
+//              from a folder or a packed suite file.
+// ======================================================================
+
+#include "Suite.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+string packedWorldName ( const string& path, size_t index )
+{
+	size_t slash = path.find_last_of ( '/' );
+	string pack  = slash == string::npos ? path : path.substr ( slash + 1 );
+	return pack + "/world_" + to_string ( index );
+}
+
+// Loads a folder of world files or a packed suite file
+bool loadSuite ( const string& path, Suite& suite )
+{
+	struct stat info;
+	if ( stat ( path.c_str(), &info ) != 0 )
+		return false;
+
+	if ( !S_ISDIR ( info.st_mode ) )
+	{
+		// Names and worlds grow together, and only once the whole file
+		// has read
+		ifstream					file ( path, ios::binary );
+		vector<WorldDescription>	worlds;
+		if ( !WorldDescription::readPacked ( file, worlds ) )
+			return false;
+		for ( size_t k = 0; k < worlds.size(); ++k )
+		{
+			suite.names.push_back ( packedWorldName ( path, k ) );
+			suite.worlds.push_back ( move ( worlds[k] ) );
+		}
+		return true;
+	}
+
+	DIR* dir = opendir ( path.c_str() );
+	if ( dir == NULL )
+		return false;
+
+	vector<string> files;
+	for ( struct dirent* ent; ( ent = readdir ( dir ) ) != NULL; )
+		if ( ent->d_name[0] != '.' )
+			files.push_back ( ent->d_name );
+	closedir ( dir );
+	sort ( files.begin(), files.end() );
+
+	for ( const string& name : files )
+	{
+		// A generated folder may hold a packed suite
+		if ( name.size() > 5 && name.compare ( name.size() - 5, 5, ".pack" ) == 0 )
+		{
+			if ( !loadSuite ( path + "/" + name, suite ) )
+				cout << "[WARNING] Skipping " << path << "/" << name << ", which failed to read." << endl;
+			continue;
+		}
+
+		ifstream			file ( path + "/" + name );
+		WorldDescription	world;
+		if ( !world.read ( file ) )
+		{
+			cout << "[WARNING] Skipping " << path << "/" << name << ", which failed to parse." << endl;
+			continue;
+		}
+		suite.names.push_back ( name );
+		suite.worlds.push_back ( move ( world ) );
+	}
+	return true;
+}
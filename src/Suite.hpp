@@ -0,0 +1,43 @@
+// ======================================================================
+// FILE:        Suite.hpp
+//
+// DESCRIPTION: This file contains Suite, a named list of worlds loaded
+//              once and played many times (by the server and the compare
+//              mode).
+//
+// NOTES:       - A suite is a folder of Wumpus World Files, played in
+//                file name order, or a packed suite file (see
+//                Generator.hpp). A .pack file inside a folder is read as
+//                a packed suite.
+//
+//              - World k of a packed suite file is named <pack>/world_<k>,
+//                <pack> being the file's name without its folder, however
+//                the file is reached. Names stay unique next to world
+//                files and other packs, and a game is seeded by its name
+//                alike in every mode.
+//
+//              - A world file that fails to parse is skipped with a
+//                warning.
+// ======================================================================
+
+#ifndef SUITE_LOCK
+#define SUITE_LOCK
+
+#include <string>
+#include <vector>
+#include "WorldDescription.hpp"
+
+struct Suite
+{
+	std::vector<std::string>		names;
+	std::vector<WorldDescription>	worlds;
+};
+
+// The name of world 'index' of the packed suite file at 'path'
+std::string packedWorldName ( const std::string& path, size_t index );
+
+// Appends the worlds at 'path' to the suite. Returns false if the path
+// cannot be read or is neither a folder nor a packed suite.
+bool loadSuite ( const std::string& path, Suite& suite );
+
+#endif /* SUITE_LOCK */
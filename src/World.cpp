@@ -10,36 +10,18 @@
 // ======================================================================
 
 #include "World.hpp"
+#include "Compass.hpp"
 
 using namespace std;
 
 // ===============================================================
-// =				Constructor and Destructor
+// =				Constructors and Assignment
 // ===============================================================	
 
-World::World ( bool _debug, bool _randomAI, bool _manualAI, string filename )
+World::World ( bool _debug, bool _randomAI, bool _manualAI, string filename, uint64_t seed )
+	: random ( seed )
 {
-	// Operation Flags
-	debug        = _debug;
-	manualAI     = _manualAI;
-	
-	// Agent Initialization
-	goldLooted   = false;
-	hasArrow     = true;
-	bump         = false;
-	scream       = false;
-	score        = 0;
-	agentDir     = 0;
-	agentX       = 0;
-	agentY       = 0;
-	lastAction   = Agent::CLIMB;
-	
-	if ( _randomAI )
-		agent = new RandomAI();
-	else if ( _manualAI )
-		agent = new ManualAI();
-	else
-		agent = new MyAI();
+	initialize ( _debug, _manualAI, makeAgent ( _randomAI, _manualAI, seed ) );
 	
 	// Board Initialization
 	if ( filename != "" )
@@ -47,173 +29,352 @@ World::World ( bool _debug, bool _randomAI, bool _manualAI, string filename )
 		ifstream file;
 		file.open(filename);
 		
-		file >> colDimension >> rowDimension;
-		if (file.fail())
+		WorldDescription description;
+		if ( !description.read ( file ) )
 			throw exception();
 
-		board = new Tile*[colDimension];
-		for ( int index = 0; index < colDimension; ++index )
-			board[index] = new Tile[rowDimension];
-
-		addFeatures ( file );
+		addFeatures ( description );
 		file.close();
 	}
 	else
 	{
-		colDimension = 4;
-		rowDimension = 4;
-		
-		board = new Tile*[colDimension];
-		for ( int index = 0; index < colDimension; ++index )
-			board[index] = new Tile[rowDimension];
+		game.colDimension = 4;
+		game.rowDimension = 4;
 			
 		addFeatures ( );
 	}
 }
 
-World::~World()
+World::World ( const WorldDescription& description, bool _debug, bool _randomAI, bool _manualAI, uint64_t seed )
+	: random ( seed )
 {
-	for ( int index = 0; index < colDimension; ++index )
-		delete [] board[index];
+	initialize ( _debug, _manualAI, makeAgent ( _randomAI, _manualAI, seed ) );
+	addFeatures ( description );
+}
+
+World::World ( const WorldDescription& description, Agent* _agent, bool _debug )
+{
+	initialize ( _debug, false, _agent );
+	addFeatures ( description );
+}
+
+void World::initialize ( bool _debug, bool _manualAI, Agent* _agent )
+{
+	// Operation Flags
+	debug        = _debug;
+	manualAI     = _manualAI;
+	
+	outcome      = IN_PROGRESS;
+	
+	// Agent Initialization
+	prefixCache  = NULL;
+	analytics    = NULL;
 	
-	delete [] board;
-	delete agent;
+	agent.reset ( _agent );
+	myAI = dynamic_cast<MyAI*> ( agent.get() );
+}
+
+Agent* World::makeAgent ( bool randomAI, bool manualAI, uint64_t seed )
+{
+	if ( randomAI )
+		return new RandomAI ( agentSeed ( seed ) );
+	else if ( manualAI )
+		return new ManualAI();
+	else
+		return new MyAI();
+}
+
+void World::reset ( const WorldDescription& description, uint64_t seed )
+{
+	game    = GameState();
+	timing  = Timing();
+	outcome = IN_PROGRESS;
+	random  = SplitMix64 ( seed );
+	
+	agent->reset ( agentSeed ( seed ) );
+	addFeatures ( description );
+}
+
+void World::reset ( const GameState& start, uint64_t seed )
+{
+	game    = start;
+	timing  = Timing();
+	outcome = IN_PROGRESS;
+	random  = SplitMix64 ( seed );
+	
+	agent->reset ( agentSeed ( seed ) );
+}
+
+World::World ( const World& other )
+	: debug       ( other.debug ),
+	  manualAI    ( other.manualAI ),
+	  renderer    ( other.renderer ),
+	  random      ( other.random ),
+	  agent       ( other.agent->clone() ),
+	  myAI        ( dynamic_cast<MyAI*>( agent.get() ) ),
+	  prefixCache ( other.prefixCache ),
+	  analytics   ( other.analytics ),
+	  game        ( other.game ),
+	  budget      ( other.budget ),
+	  timing      ( other.timing ),
+	  outcome     ( other.outcome )
+{
+}
+
+World& World::operator= ( const World& other )
+{
+	if ( this != &other )
+		*this = World ( other );
+	return *this;
+}
+
+// ===============================================================
+// =					State Access Functions
+// ===============================================================	
+
+void World::restore ( const GameState& state )
+{
+	game = state;
+}
+
+World::Snapshot World::snapshot ( void ) const
+{
+	Snapshot snapshot;
+	snapshot.game = game;
+	if ( myAI )
+		snapshot.agent = myAI->snapshot();
+	return snapshot;
+}
+
+void World::restore ( const Snapshot& snapshot )
+{
+	game = snapshot.game;
+	if ( myAI )
+		myAI->restore ( snapshot.agent );
 }
 
 // ===============================================================
 // =					Engine Function
 // ===============================================================	
 
+void World::setPrefixCache ( PrefixCache* cache )
+{
+	prefixCache = cache;
+}
+
+void World::setAnalytics ( SpatialStats* stats )
+{
+	analytics = stats;
+}
+
+void World::setRenderer ( const FrameRenderer& _renderer )
+{
+	renderer = _renderer;
+}
+
+void World::setTimeBudget ( const TimeBudget& _budget )
+{
+	budget = _budget;
+}
+
 int World::run ( void )
 {	
-	while ( score >= -1000 )
+	PROFILE_TIMER ( TIMER_WORLD_RUN );
+	
+	// Prefix cache state: while 'replaying', actions come from the cache
+	// and 'resumeFrom' is the last entry used
+	bool		caching    = prefixCache && myAI && !debug;
+	bool		replaying  = caching;
+	uint64_t	history    = PrefixCache::EMPTY_HISTORY;
+	const PrefixCache::Entry* resumeFrom = NULL;
+	
+	// Only read the clock when there is a budget to enforce
+	bool	timed = budget.perMove.count() > 0 || budget.perGame.count() > 0;
+	timing  = Timing();
+	outcome = IN_PROGRESS;
+	
+	if ( analytics )
+		analytics->startGame();
+	
+	while ( game.score >= -1000 )
 	{
+		// The renderer pauses the game unless manualAI is on,
+		// because manualAI pauses for us
 		if ( debug || manualAI )
-		{
 			printWorldInfo();
+		
+		// Get the move
+		const Tile& tile = game.board[game.agentX][game.agentY];
+		
+		if ( caching )
+			history = PrefixCache::extend ( history, tile.stench, tile.breeze, tile.gold, game.bump, game.scream );
+		
+		if ( replaying )
+		{
+			const PrefixCache::Entry* cached = prefixCache->find ( history );
 			
-			if ( !manualAI )
+			if ( cached )
+				resumeFrom = cached;
+			else
 			{
-				// Pause the game, only if manualAI isn't on
-				// because manualAI pauses for us
-				cout << "Press ENTER to continue..." << endl;
-				cin.ignore( 999, '\n');
+				// First unseen history: bring the agent up to date and
+				// let it play the rest of the game on its own
+				replaying = false;
+				if ( resumeFrom )
+					myAI->restore ( resumeFrom->state );
 			}
 		}
 		
-		// Get the move
-		lastAction = agent->getAction
-		(
-			board[agentX][agentY].stench,
-			board[agentX][agentY].breeze,
-			board[agentX][agentY].gold,
-			bump,
-			scream
-		);
+		if ( replaying )
+			game.lastAction = resumeFrom->action;
+		else
+		{
+			chrono::steady_clock::time_point moveStart;
+			if ( timed )
+				moveStart = chrono::steady_clock::now();
+			
+			game.lastAction = agent->getAction
+			(
+				tile.stench,
+				tile.breeze,
+				tile.gold,
+				game.bump,
+				game.scream
+			);
+			
+			if ( timed && overBudget ( chrono::steady_clock::now() - moveStart ) && budget.forfeit )
+			{
+				// Forfeiting costs as much as dying
+				game.score -= 1000;
+				outcome = FORFEITED;
+				if (debug) printWorldInfo ( true );
+				return game.score;
+			}
+			
+			if ( caching )
+				prefixCache->insert ( history, game.lastAction, myAI->snapshot() );
+		}
 
 		// Make the move
-		--score;
-		bump   = false;
-		scream = false;
+		--game.score;
+		game.bump   = false;
+		game.scream = false;
 		
-		switch ( lastAction )
+		switch ( game.lastAction )
 		{
 			case Agent::TURN_LEFT:
-				if (--agentDir > 3) agentDir = 3;	// This works because size_t is unsigned
+				PROFILE_COUNT ( WORLD_TURN_LEFT );
+				game.agentDir = Compass::LEFT_OF[game.agentDir];
 				break;
 				
 			case Agent::TURN_RIGHT:
-				if (++agentDir > 3) agentDir = 0;
+				PROFILE_COUNT ( WORLD_TURN_RIGHT );
+				game.agentDir = Compass::RIGHT_OF[game.agentDir];
 				break;
 				
 			case Agent::FORWARD:
-				if ( agentDir == 0 && agentX+1 < colDimension )
-					++agentX;
-				else if ( agentDir == 1 && agentY-1 < rowDimension ) // This still works because size_t
-					--agentY;
-				else if ( agentDir == 2 && agentX-1 < colDimension ) // gets big, instead of going negative
-					--agentX;
-				else if ( agentDir == 3 && agentY+1 < rowDimension )
-					++agentY;
+			{
+				PROFILE_COUNT ( WORLD_FORWARD );
+				// A step off the low edge wraps the unsigned coordinate
+				// round to a huge value, so one comparison per axis
+				// catches both edges
+				size_t x = game.agentX + Compass::DX[game.agentDir];
+				size_t y = game.agentY + Compass::DY[game.agentDir];
+				if ( x < game.colDimension && y < game.rowDimension )
+				{
+					game.agentX = x;
+					game.agentY = y;
+					if ( analytics )
+						analytics->visit ( x, y );
+				}
 				else
-					bump = true;
+				{
+					game.bump = true;
+					if ( analytics )
+						analytics->bump ( game.agentX, game.agentY );
+				}
 				
-				if ( board[agentX][agentY].pit || board[agentX][agentY].wumpus )
+				if ( game.board[game.agentX][game.agentY].pit || game.board[game.agentX][game.agentY].wumpus )
 				{
-					score -= 1000;
-					if (debug) printWorldInfo();
-					return score;
+					if ( analytics )
+						analytics->died ( game.agentX, game.agentY, game.board[game.agentX][game.agentY].pit );
+					game.score -= 1000;
+					outcome = DIED;
+					if (debug) printWorldInfo ( true );
+					return game.score;
 				}
 				break;
+			}
 			
 			case Agent::SHOOT:
-				if ( hasArrow )
+				PROFILE_COUNT ( WORLD_SHOOT );
+				if ( game.hasArrow )
 				{
-					hasArrow = false;
-					score -= 10;
-					if ( agentDir == 0 )
-					{
-						for ( size_t x = agentX; x < colDimension; ++x )
-							if ( board[x][agentY].wumpus )
-							{
-								board[x][agentY].wumpus = false;
-								board[x][agentY].stench = true;
-								scream = true;
-							}
-					}
-					else if ( agentDir == 1 )
-					{
-						for ( size_t y = agentY; y < rowDimension; --y )
-							if ( board[agentX][y].wumpus )
-							{
-								board[agentX][y].wumpus = false;
-								board[agentX][y].stench = true;
-								scream = true;
-							}
-					}
-					else if ( agentDir == 2 )
-					{
-						for ( size_t x = agentX; x < colDimension; --x )
-							if ( board[x][agentY].wumpus )
-							{
-								board[x][agentY].wumpus = false;
-								board[x][agentY].stench = true;
-								scream = true;
-							}
-					}
-					else if ( agentDir == 3 )
-					{
-						for ( size_t y = agentY; y < rowDimension; ++y )
-							if ( board[agentX][y].wumpus )
-							{
-								board[agentX][y].wumpus = false;
-								board[agentX][y].stench = true;
-								scream = true;
-							}
-					}
+					game.hasArrow = false;
+					game.score -= 10;
+					
+					// The arrow flies from the agent's cell to the wall
+					int dx = Compass::DX[game.agentDir];
+					int dy = Compass::DY[game.agentDir];
+					for ( size_t x = game.agentX, y = game.agentY;
+							x < game.colDimension && y < game.rowDimension;
+							x += dx, y += dy )
+						if ( game.board[x][y].wumpus )
+						{
+							game.board[x][y].wumpus = false;
+							game.board[x][y].stench = true;
+							game.scream = true;
+						}
+					
+					if ( analytics && !game.scream )
+						analytics->missed ( game.agentX, game.agentY );
 				}
 				break;
 				
 			case Agent::GRAB:
-				if ( board[agentX][agentY].gold )
+				PROFILE_COUNT ( WORLD_GRAB );
+				if ( game.board[game.agentX][game.agentY].gold )
 				{
-					board[agentX][agentY].gold = false;
-					goldLooted = true;
+					game.board[game.agentX][game.agentY].gold = false;
+					game.goldLooted = true;
 				}
 				break;
 				
 			case Agent::CLIMB:
-				if ( agentX == 0 && agentY == 0 )
+				PROFILE_COUNT ( WORLD_CLIMB );
+				if ( game.agentX == 0 && game.agentY == 0 )
 				{
-					if ( goldLooted )
-						score += 1000;
-					if (debug) printWorldInfo();
-					return score;
+					if ( game.goldLooted )
+						game.score += 1000;
+					outcome = CLIMBED;
+					if (debug) printWorldInfo ( true );
+					return game.score;
 				}
 				break;
 		}
 	}
-	return score;
+	outcome = EXHAUSTED;
+	if (debug) printWorldInfo ( true );
+	return game.score;
+}
+
+bool World::overBudget ( chrono::nanoseconds elapsed )
+{
+	++timing.moves;
+	timing.total += elapsed;
+	if ( elapsed > timing.slowestMove )
+		timing.slowestMove = elapsed;
+	
+	bool over = budget.perMove.count() > 0 && elapsed > budget.perMove;
+	if ( over )
+		++timing.overBudgetMoves;
+	
+	if ( budget.perGame.count() > 0 && timing.total > budget.perGame )
+	{
+		timing.overBudgetGame = true;
+		over = true;
+	}
+	return over;
 }
 
 // ===============================================================
@@ -223,73 +384,56 @@ int World::run ( void )
 void World::addFeatures ( void )
 {		
 	// Generate pits
-	for ( int r = 0; r < rowDimension; ++r )
-		for ( int c = 0; c < colDimension; ++c )
+	for ( int r = 0; r < game.rowDimension; ++r )
+		for ( int c = 0; c < game.colDimension; ++c )
 			if ( (c != 0 || r != 0) && randomInt(10) < 2 )
 				addPit ( c, r );
 	
 	// Generate wumpus
-	int wc = randomInt(colDimension);
-	int wr = randomInt(rowDimension);
+	int wc = randomInt(game.colDimension);
+	int wr = randomInt(game.rowDimension);
 	
 	while ( wc == 0 && wr == 0 )
 	{
-		wc = randomInt(colDimension);
-		wr = randomInt(rowDimension);
+		wc = randomInt(game.colDimension);
+		wr = randomInt(game.rowDimension);
 	}
 	
 	addWumpus ( wc, wr );
 	
 	// Generate gold
-	int gc = randomInt(colDimension);
-	int gr = randomInt(rowDimension);
+	int gc = randomInt(game.colDimension);
+	int gr = randomInt(game.rowDimension);
 		
 	while ( gc == 0 && gr == 0 )
 	{
-		gc = randomInt(colDimension);
-		gr = randomInt(rowDimension);
+		gc = randomInt(game.colDimension);
+		gr = randomInt(game.rowDimension);
 	}
 	
 	addGold ( gc, gr );
 }	
 
-void World::addFeatures ( ifstream &file )
+void World::addFeatures ( const WorldDescription& description )
 {
-	int c, r;
-	
-	// Add the Wumpus
-	file >> c >> r;
-	if (file.fail())
+	if ( !description.isPlayable() )
 		throw exception();
-	addWumpus ( c, r );
 	
-	// Add the Gold
-	file >> c >> r;
-	if (file.fail())
-		throw exception();
-	addGold ( c, r );
+	game.colDimension = description.colDimension;
+	game.rowDimension = description.rowDimension;
 	
-	// Add the Pits
-	int numOfPits;
-	file >> numOfPits;
-	if (file.fail())
-		throw exception();
+	addWumpus ( description.wumpus.c, description.wumpus.r );
+	addGold ( description.gold.c, description.gold.r );
 	
-	while ( numOfPits > 0 && !file.eof() )
-	{
-		--numOfPits;
-		file >> c >> r;
-		if (file.fail())
-			throw exception();
-		addPit ( c, r );
-	}
+	for ( const WorldDescription::Cell& pit : description.pits )
+		addPit ( pit.c, pit.r );
 }
 
 void World::addPit ( size_t c, size_t r )
 {
 	if ( isInBounds(c, r) )
 	{
-		board[c][r].pit = true;
+		game.board[c][r].pit = true;
 		addBreeze ( c+1, r );
 		addBreeze ( c-1, r );
 		addBreeze ( c, r+1 );
@@ -301,7 +445,7 @@ void World::addWumpus ( size_t c, size_t r )
 {
 	if ( isInBounds(c, r) )
 	{
-		board[c][r].wumpus = true;
+		game.board[c][r].wumpus = true;
 		addStench ( c+1, r );
 		addStench ( c-1, r );
 		addStench ( c, r+1 );
@@ -312,157 +456,177 @@ void World::addWumpus ( size_t c, size_t r )
 void World::addGold ( size_t c, size_t r )
 {
 	if ( isInBounds(c, r) )
-		board[c][r].gold = true;
+		game.board[c][r].gold = true;
 }
 
 void World::addStench ( size_t c, size_t r )
 {
 	if ( isInBounds(c, r) )
-		board[c][r].stench = true;
+		game.board[c][r].stench = true;
 }
 
 void World::addBreeze ( size_t c, size_t r )
 {
 	if ( isInBounds(c, r) )
-		board[c][r].breeze = true;
+		game.board[c][r].breeze = true;
 }
 
 bool World::isInBounds ( size_t c, size_t r )
 {
-	return ( c < colDimension && r < rowDimension );
+	return ( c < game.colDimension && r < game.rowDimension );
 }
 
 // ===============================================================
 // =				World Printing Functions
 // ===============================================================
 
-void World::printWorldInfo ( void )
+void World::printWorldInfo ( bool last )
 {
-	printBoardInfo();
-	printAgentInfo();
+	string& frame = renderer.beginFrame();
+	printBoardInfo ( frame );
+	printAgentInfo ( frame );
+	renderer.endFrame ( !manualAI, last );
+	
+	if ( last )
+		renderer.finish();
 }
 
-void World::printBoardInfo ( void )
+void World::printBoardInfo ( string& frame )
 {
-	for ( int r = rowDimension-1; r >= 0; --r )
+	for ( int r = game.rowDimension-1; r >= 0; --r )
 	{
-		for ( int c = 0; c < colDimension; ++c )
-			printTileInfo ( c, r );
-		cout << endl << endl;
+		for ( int c = 0; c < game.colDimension; ++c )
+			printTileInfo ( frame, c, r );
+		frame.append ( "\n\n" );
 	}
 }
 
-void World::printTileInfo ( size_t c, size_t r )
+void World::printTileInfo ( string& frame, size_t c, size_t r )
 {
-	string tileString = "";
+	const Tile& tile = game.board[c][r];
+	char	tileString[8];
+	size_t	length = 0;
 	
-	if (board[c][r].pit)    tileString.append("P");
-	if (board[c][r].wumpus) tileString.append("W");
-	if (board[c][r].gold)   tileString.append("G");
-	if (board[c][r].breeze) tileString.append("B");
-	if (board[c][r].stench) tileString.append("S");
+	if (tile.pit)    tileString[length++] = 'P';
+	if (tile.wumpus) tileString[length++] = 'W';
+	if (tile.gold)   tileString[length++] = 'G';
+	if (tile.breeze) tileString[length++] = 'B';
+	if (tile.stench) tileString[length++] = 'S';
 	
-	if ( agentX == c && agentY == r )
-		tileString.append("@");
+	if ( game.agentX == c && game.agentY == r )
+		tileString[length++] = '@';
 	
-	tileString.append(".");
+	tileString[length++] = '.';
 	
-	cout << setw(8) << tileString;
+	// Right aligned in a column of 8, as setw(8) used to do
+	frame.append ( 8 - length, ' ' );
+	frame.append ( tileString, length );
 }
 
-void World::printAgentInfo ( void )
+void World::printAgentInfo ( string& frame )
 {
-	cout << "Score: "       << score    << endl;
-	cout << "AgentX: "      << agentX   << endl;
-	cout << "AgentY: "      << agentY   << endl;
-	printDirectionInfo();
-	printActionInfo();
-	printPerceptInfo();
+	frame.append ( "Score: " ).append ( to_string ( game.score ) ).append ( "\n" );
+	frame.append ( "AgentX: " ).append ( to_string ( game.agentX ) ).append ( "\n" );
+	frame.append ( "AgentY: " ).append ( to_string ( game.agentY ) ).append ( "\n" );
+	printDirectionInfo ( frame );
+	printActionInfo ( frame );
+	printPerceptInfo ( frame );
 }
 
-void World::printDirectionInfo ( void )
+void World::printDirectionInfo ( string& frame )
 {
-	switch (agentDir)
+	switch (game.agentDir)
 	{
 		case 0:
-			cout << "AgentDir: Right" << endl;
+			frame.append ( "AgentDir: Right\n" );
 			break;
 			
 		case 1:
-			cout << "AgentDir: Down" << endl;
+			frame.append ( "AgentDir: Down\n" );
 			break;
 			
 		case 2:
-			cout << "AgentDir: Left" << endl;
+			frame.append ( "AgentDir: Left\n" );
 			break;
 			
 		case 3:
-			cout << "AgentDir: Up" << endl;
+			frame.append ( "AgentDir: Up\n" );
 			break;
 			
 		default:
-			cout << "AgentDir: Invalid" << endl;
+			frame.append ( "AgentDir: Invalid\n" );
 	}
 }
 
-void World::printActionInfo ( void )
+void World::printActionInfo ( string& frame )
 {
-	switch (lastAction)
+	switch (game.lastAction)
 	{
 		case Agent::TURN_LEFT:
-			cout << "Last Action: Turned Left" << endl;
+			frame.append ( "Last Action: Turned Left\n" );
 			break;
 			
 		case Agent::TURN_RIGHT:
-			cout << "Last Action: Turned Right" << endl;
+			frame.append ( "Last Action: Turned Right\n" );
 			break;
 			
 		case Agent::FORWARD:
-			cout << "Last Action: Moved Forward" << endl;
+			frame.append ( "Last Action: Moved Forward\n" );
 			break;
 			
 		case Agent::SHOOT:
-			cout << "Last Action: Shot the arrow" << endl;
+			frame.append ( "Last Action: Shot the arrow\n" );
 			break;
 			
 		case Agent::GRAB:
-			cout << "Last Action: Grabbed" << endl;
+			frame.append ( "Last Action: Grabbed\n" );
 			break;
 			
 		case Agent::CLIMB:
-			cout << "Last Action: Climbed" << endl;
+			frame.append ( "Last Action: Climbed\n" );
 			break;
 			
 		default:
-			cout << "Last Action: Invalid" << endl;
+			frame.append ( "Last Action: Invalid\n" );
 	}
 }
 
-void World::printPerceptInfo ( void )
+void World::printPerceptInfo ( string& frame )
 {
-	string perceptString = "Percepts: ";
+	const Tile& tile = game.board[game.agentX][game.agentY];
+	size_t start = frame.size();
+	
+	frame.append ( "Percepts: " );
 	
-	if (board[agentX][agentY].stench) perceptString.append("Stench, ");
-	if (board[agentX][agentY].breeze) perceptString.append("Breeze, ");
-	if (board[agentX][agentY].gold)   perceptString.append("Glitter, ");
-	if (bump)                         perceptString.append("Bump, ");
-	if (scream)                       perceptString.append("Scream");
+	if (tile.stench) frame.append ( "Stench, " );
+	if (tile.breeze) frame.append ( "Breeze, " );
+	if (tile.gold)   frame.append ( "Glitter, " );
+	if (game.bump)   frame.append ( "Bump, " );
+	if (game.scream) frame.append ( "Scream" );
 	
-	if ( perceptString[perceptString.size()-1] == ' '
-			&& perceptString[perceptString.size()-2] == ',' )
+	if ( frame.size() - start >= 2
+			&& frame[frame.size()-1] == ' '
+			&& frame[frame.size()-2] == ',' )
 	{
-		perceptString.pop_back();
-		perceptString.pop_back();
+		frame.pop_back();
+		frame.pop_back();
 	}
 	
-	cout << perceptString << endl;
+	frame.append ( "\n" );
 }
 
 // ===============================================================
 // =					Helper Functions
 // ===============================================================
 
+uint64_t World::agentSeed ( uint64_t seed )
+{
+	// Complemented so the agent does not draw the same numbers as
+	// the board
+	return ~seed;
+}
+
 int World::randomInt ( int limit )
 {
-	return rand() % limit;
+	return random.uniform ( limit );
 }
@@ -17,26 +17,29 @@
 #include<iostream>
 #include<fstream>
 #include<cstdlib>
+#include<cstdint>
 #include<exception>
+#include<memory>
+#include<chrono>
+#include<type_traits>
 #include"Agent.hpp"
+#include"WorldDescription.hpp"
 #include"ManualAI.hpp"
 #include"RandomAI.hpp"
 #include"MyAI.hpp"
+#include"PrefixCache.hpp"
+#include"Analytics.hpp"
+#include"Profiler.hpp"
+#include"FrameRenderer.hpp"
+#include"Random.hpp"
 
 class World
 {
 public:
 
-	// Constructor
-	World ( bool debug = false, bool randomAI = false, bool manualAI = false, std::string filename = "" );
+	// The largest board, in either dimension, a World can hold
+	static const size_t MAX_DIMENSION = WorldDescription::MAX_DIMENSION;
 	
-	// Destructor
-	~World();
-	
-	// Engine Function
-	int	run	( void );
-	
-private:
 	// Tile Structure
 	struct Tile
 	{
@@ -47,31 +50,154 @@ private:
 		bool stench = false;
 	};
 	
+	// GameState is everything that changes while a game is played. It is
+	// trivially copyable, so forking a game costs a single memcpy.
+	struct GameState
+	{
+		// Agent Variables
+		int 	score      = 0;			// The agent's score
+		bool	goldLooted = false;		// True if gold was successfuly looted
+		bool	hasArrow   = true;		// True if the agent can shoot
+		bool	bump       = false;		// Bump percept flag
+		bool	scream     = false;		// Scream percept flag
+		size_t	agentDir   = 0;			// The direction the agent is facing: 0 - right, 1 - down, 2 - left, 3 - up
+		size_t	agentX     = 0;			// The column where the agent is located ( x-coord = col-coord )
+		size_t	agentY     = 0;			// The row where the agent is located ( y-coord = row-coord )
+
+		Agent::Action	lastAction = Agent::CLIMB;	// The last action the agent made
+		
+		// Board Variables
+		size_t	colDimension = 0;		// The number of columns the game board has
+		size_t	rowDimension = 0;		// The number of rows the game board has
+		Tile	board[MAX_DIMENSION][MAX_DIMENSION];	// The game board, indexed [col][row]
+	};
+	
+	// Snapshot pairs the game state with MyAI's memory; the agent part is
+	// ignored when restoring a World that does not run MyAI.
+	struct Snapshot
+	{
+		GameState	game;
+		MyAI::State	agent;
+	};
+
+	// How a game ended
+	enum Outcome
+	{
+		IN_PROGRESS,	// run() has not returned yet
+		CLIMBED,		// The agent climbed out
+		DIED,			// The agent walked into a pit or the wumpus
+		EXHAUSTED,		// The score fell below -1000
+		FORFEITED		// The agent overran its time budget
+	};
+	
+	// Limits on the time the agent may spend choosing moves. A zero
+	// limit is unlimited. The engine cannot interrupt the agent, so a
+	// move is judged once getAction returns.
+	struct TimeBudget
+	{
+		std::chrono::nanoseconds	perMove { 0 };
+		std::chrono::nanoseconds	perGame { 0 };
+		bool	forfeit = false;	// End the game as FORFEITED on the first overrun
+	};
+	
+	// Agent latency measured during the last run(); only recorded when a
+	// budget is set
+	struct Timing
+	{
+		size_t	moves           = 0;	// Calls to getAction
+		size_t	overBudgetMoves = 0;	// Calls that exceeded the per-move budget
+		bool	overBudgetGame  = false;	// The per-game budget was exceeded
+		std::chrono::nanoseconds	slowestMove { 0 };
+		std::chrono::nanoseconds	total { 0 };
+	};
+	
+	// Constructor. The seed drives everything random about the game: the
+	// board when there is no file, and the RandomAI's moves.
+	World ( bool debug = false, bool randomAI = false, bool manualAI = false, std::string filename = "", uint64_t seed = 0 );
+	World ( const WorldDescription& description, bool debug = false, bool randomAI = false, bool manualAI = false, uint64_t seed = 0 );
+	
+	// Plays the described world with the given heap-allocated agent, which
+	// the World takes ownership of
+	World ( const WorldDescription& description, Agent* agent, bool debug = false );
+	
+	// Creates the agent selected by the command line flags for a game
+	// with the given seed
+	static Agent*	makeAgent	( bool randomAI, bool manualAI, uint64_t seed = 0 );
+	
+	// The seed the agent of a game with the given seed is made or reset
+	// with, so an agent reused outside a World plays the same moves
+	static uint64_t	agentSeed	( uint64_t seed );
+	
+	// Sets the World up to play the described world from the start, as if
+	// newly constructed with the same flags and agent but the given seed.
+	// The World and its agent are reused rather than rebuilt, so a worker
+	// can play any number of games without allocating. Throws like the
+	// constructor if the description is invalid.
+	void	reset		( const WorldDescription& description, uint64_t seed = 0 );
+	
+	// Like reset ( description, seed ), but starts from a state whose
+	// board was built elsewhere, such as a board the search edits in
+	// place (see Search.hpp). The state is played as given.
+	void	reset		( const GameState& start, uint64_t seed = 0 );
+	
+	// Copying a World clones its agent; moving it transfers the agent
+	World ( const World& other );
+	World ( World&& other ) = default;
+	World&	operator=	( const World& other );
+	World&	operator=	( World&& other ) = default;
+	
+	// Engine Function
+	int	run	( void );
+	
+	// Replays MyAI's decisions from the cache when the percept history
+	// matches a known prefix. Has no effect with the other agents.
+	void	setPrefixCache	( PrefixCache* cache );
+	
+	// Counts every run() in 'stats' and records where the agent goes and
+	// what goes wrong (see Analytics.hpp); NULL to stop
+	void	setAnalytics	( SpatialStats* stats );
+	
+	// Sets how debug frames are paced; see FrameRenderer
+	void	setRenderer		( const FrameRenderer& renderer );
+	
+	// Enforces agent time limits; see TimeBudget
+	void	setTimeBudget	( const TimeBudget& budget );
+	
+	// Results of the last run()
+	Outcome			getOutcome	( void ) const { return outcome; }
+	const Timing&	getTiming	( void ) const { return timing; }
+	
+	// State Access Functions
+	const GameState&	state		( void ) const { return game; }
+	void	restore		( const GameState& state );
+	Snapshot	snapshot	( void ) const;
+	void	restore		( const Snapshot& snapshot );
+	
+private:
 	// Operation Variables
 	bool 	debug;			// If true, displays board info after every move
 	bool	manualAI;		// If true, alters the behavior of debug for flow purposes
+	FrameRenderer	renderer;	// Draws and paces the debug display
+	SplitMix64		random;		// Draws the random board
 	
 	// Agent Variables
-	Agent* 	agent;			// The agent
-	int 	score;			// The agent's score
-	bool	goldLooted;		// True if gold was successfuly looted
-	bool	hasArrow;		// True if the agent can shoot
-	bool	bump;			// Bump percept flag
-	bool	scream;			// Scream percept flag
-	size_t	agentDir;		// The direction the agent is facing: 0 - right, 1 - down, 2 - left, 3 - up
-	size_t	agentX;			// The column where the agent is located ( x-coord = col-coord )
-	size_t	agentY;			// The row where the agent is located ( y-coord = row-coord )
-
-	Agent::Action	lastAction;	// The last action the agent made
+	std::unique_ptr<Agent>	agent;	// The agent
+	MyAI*	myAI;			// The agent, if it is MyAI; NULL otherwise
+	PrefixCache*	prefixCache;	// Shared decision cache, or NULL if disabled
+	SpatialStats*	analytics;		// Where games are recorded, or NULL
 	
-	// Board Variables
-	size_t	colDimension;	// The number of columns the game board has
-	size_t	rowDimension;	// The number of rows the game board has
-	Tile**	board;			// The game board
+	// Game Variables
+	GameState	game;
+	
+	// Timing Variables
+	TimeBudget	budget;
+	Timing		timing;
+	Outcome		outcome;
 	
 	// World Generation Functions
+	void	initialize	( bool debug, bool manualAI, Agent* agent );	// Sets up the flags and takes the agent
 	void 	addFeatures	( void );					// Populates the board with random features
-	void	addFeatures ( std::ifstream &file );	// Populates the board with features specified in file
+	void	addFeatures ( const WorldDescription& description );	// Populates the board with the described features
 	void 	addPit 		( size_t c, size_t r );
 	void 	addWumpus	( size_t c, size_t r );
 	void 	addGold		( size_t c, size_t r );
@@ -80,16 +206,19 @@ private:
 	bool 	isInBounds	( size_t c, size_t r );
 	
 	// World Printing Functions
-	void	printWorldInfo		( void );
-	void	printBoardInfo		( void );
-	void	printTileInfo		( size_t c, size_t r );
-	void	printAgentInfo		( void );
-	void	printDirectionInfo	( void );
-	void	printActionInfo		( void );
-	void	printPerceptInfo	( void );
+	void	printWorldInfo		( bool last = false );	// Draws a frame and hands it to the renderer
+	void	printBoardInfo		( std::string& frame );
+	void	printTileInfo		( std::string& frame, size_t c, size_t r );
+	void	printAgentInfo		( std::string& frame );
+	void	printDirectionInfo	( std::string& frame );
+	void	printActionInfo		( std::string& frame );
+	void	printPerceptInfo	( std::string& frame );
 
 	// Helper Functions
 	int		randomInt	( int limit );		// Randomly generate a int in the range [0, limit)
+	bool	overBudget	( std::chrono::nanoseconds elapsed );	// Records a move's latency; true if a budget was exceeded
 };
 
+static_assert ( std::is_trivially_copyable<World::GameState>::value, "GameState must stay trivially copyable" );
+
 #endif /* WORLD_LOCK */
\ No newline at end of file
@@ -0,0 +1,252 @@
+// ======================================================================
+// FILE:        WorldDescription.cpp
+//
+// DESCRIPTION: This file contains the world description, the parsed
+//              form of a Wumpus World File.
+// ======================================================================
+
+#include "WorldDescription.hpp"
+#include "Hash.hpp"
+#include "Compass.hpp"
+
+#include <cstring>
+#include <iterator>
+
+using namespace std;
+
+// Leads every packed stream, so a text file is never mistaken for one
+static const char PACKED_MAGIC[4] = { 'W', 'W', 'P', '1' };
+
+// ===============================================================
+// =					Text Format
+// ===============================================================
+
+bool WorldDescription::read ( istream& in )
+{
+	in >> colDimension >> rowDimension;
+	if ( in.fail() || colDimension <= 0 || rowDimension <= 0
+			|| colDimension > MAX_DIMENSION || rowDimension > MAX_DIMENSION )
+		return false;
+
+	in >> wumpus.c >> wumpus.r;
+	if ( in.fail() )
+		return false;
+
+	in >> gold.c >> gold.r;
+	if ( in.fail() )
+		return false;
+
+	int numOfPits;
+	in >> numOfPits;
+	if ( in.fail() )
+		return false;
+
+	pits.clear();
+	while ( numOfPits > 0 && !in.eof() )
+	{
+		--numOfPits;
+		Cell pit;
+		in >> pit.c >> pit.r;
+		if ( in.fail() )
+			return false;
+		pits.push_back ( pit );
+	}
+	return true;
+}
+
+void WorldDescription::write ( ostream& out ) const
+{
+	out << colDimension << " " << rowDimension << '\n';
+	out << wumpus.c << " " << wumpus.r << '\n';
+	out << gold.c << " " << gold.r << '\n';
+	out << pits.size() << '\n';
+	for ( const Cell& pit : pits )
+		out << pit.c << " " << pit.r << '\n';
+}
+
+// ===============================================================
+// =					Packed Format
+// ===============================================================
+
+WorldDescription::PackedWorld WorldDescription::pack ( void ) const
+{
+	return PackedWorld { encode() };
+}
+
+// A feature encodes as a cell on the board, or as 0xFF in both bytes
+static bool validFeature ( unsigned char c, unsigned char r, int cols, int rows )
+{
+	return ( c == 0xFF && r == 0xFF ) || ( c < cols && r < rows );
+}
+
+bool WorldDescription::unpack ( const PackedWorld& packed )
+{
+	const Encoding& e = packed.encoding;
+
+	// The pit bits only cover boards up to MAX_DIMENSION on a side
+	if ( e[0] < 1 || e[0] > MAX_DIMENSION || e[1] < 1 || e[1] > MAX_DIMENSION
+			|| !validFeature ( e[2], e[3], e[0], e[1] ) || !validFeature ( e[4], e[5], e[0], e[1] ) )
+		return false;
+
+	colDimension = e[0];
+	rowDimension = e[1];
+	wumpus       = { e[2] == 0xFF ? -1 : e[2], e[3] == 0xFF ? -1 : e[3] };
+	gold         = { e[4] == 0xFF ? -1 : e[4], e[5] == 0xFF ? -1 : e[5] };
+
+	pits.clear();
+	for ( int r = 0; r < rowDimension; ++r )
+		for ( int c = 0; c < colDimension; ++c )
+		{
+			int bit = r * colDimension + c;
+			if ( e[6 + bit / 8] & ( 1 << ( bit % 8 ) ) )
+				pits.push_back ( { c, r } );
+		}
+	return true;
+}
+
+void WorldDescription::writePacked ( ostream& out, const vector<WorldDescription>& worlds )
+{
+	out.write ( PACKED_MAGIC, sizeof PACKED_MAGIC );
+	for ( const WorldDescription& world : worlds )
+	{
+		PackedWorld packed = world.pack();
+		out.write ( reinterpret_cast<const char*> ( packed.encoding.data() ), packed.encoding.size() );
+	}
+}
+
+bool WorldDescription::readPacked ( istream& in, vector<WorldDescription>& worlds )
+{
+	char magic[sizeof PACKED_MAGIC];
+	if ( !in.read ( magic, sizeof magic ) || memcmp ( magic, PACKED_MAGIC, sizeof magic ) != 0 )
+		return false;
+
+	// Decoded on the side, so a bad stream leaves 'worlds' as it was
+	vector<WorldDescription>	decoded;
+	PackedWorld					packed;
+	while ( in.read ( reinterpret_cast<char*> ( packed.encoding.data() ), packed.encoding.size() ) )
+	{
+		decoded.emplace_back();
+		if ( !decoded.back().unpack ( packed ) )
+			return false;
+	}
+
+	// A trailing partial record means the stream was cut short
+	if ( in.gcount() != 0 )
+		return false;
+
+	worlds.insert ( worlds.end(), make_move_iterator ( decoded.begin() ), make_move_iterator ( decoded.end() ) );
+	return true;
+}
+
+// ===============================================================
+// =				Canonical Form and Solvability
+// ===============================================================
+
+WorldDescription::Encoding WorldDescription::encode ( void ) const
+{
+	Encoding e = {};
+
+	e[0] = colDimension;
+	e[1] = rowDimension;
+
+	if ( isInBounds ( wumpus.c, wumpus.r ) )
+	{
+		e[2] = wumpus.c;
+		e[3] = wumpus.r;
+	}
+	else
+		e[2] = e[3] = 0xFF;
+
+	if ( isInBounds ( gold.c, gold.r ) )
+	{
+		e[4] = gold.c;
+		e[5] = gold.r;
+	}
+	else
+		e[4] = e[5] = 0xFF;
+
+	for ( const Cell& pit : pits )
+		if ( isInBounds ( pit.c, pit.r ) )
+		{
+			int bit = pit.r * colDimension + pit.c;
+			e[6 + bit / 8] |= 1 << ( bit % 8 );
+		}
+
+	return e;
+}
+
+WorldDescription WorldDescription::transposed ( void ) const
+{
+	WorldDescription mirror;
+
+	mirror.colDimension = rowDimension;
+	mirror.rowDimension = colDimension;
+	mirror.wumpus       = { wumpus.r, wumpus.c };
+	mirror.gold         = { gold.r, gold.c };
+	mirror.pits.reserve ( pits.size() );
+	for ( const Cell& pit : pits )
+		mirror.pits.push_back ( { pit.r, pit.c } );
+
+	return mirror;
+}
+
+WorldDescription::Encoding WorldDescription::canonicalEncoding ( void ) const
+{
+	Encoding original = encode();
+	Encoding mirror   = transposed().encode();
+	return mirror < original ? mirror : original;
+}
+
+uint64_t WorldDescription::key ( void ) const
+{
+	Encoding e = encode();
+	return Hash::fnv1a ( e.data(), e.size() );
+}
+
+uint64_t WorldDescription::canonicalKey ( void ) const
+{
+	Encoding e = canonicalEncoding();
+	return Hash::fnv1a ( e.data(), e.size() );
+}
+
+bool WorldDescription::isSolvable ( void ) const
+{
+	if ( !isInBounds ( gold.c, gold.r ) )
+		return false;
+
+	// Blocked cells, then a breadth first search from the start
+	bool	blocked [MAX_DIMENSION][MAX_DIMENSION] = {};
+	bool	seen    [MAX_DIMENSION][MAX_DIMENSION] = {};
+	Cell	queue   [MAX_DIMENSION * MAX_DIMENSION];
+	int		head = 0, tail = 0;
+
+	for ( const Cell& pit : pits )
+		if ( isInBounds ( pit.c, pit.r ) )
+			blocked[pit.c][pit.r] = true;
+	if ( isInBounds ( wumpus.c, wumpus.r ) )
+		blocked[wumpus.c][wumpus.r] = true;
+
+	if ( blocked[0][0] || blocked[gold.c][gold.r] )
+		return false;
+
+	seen[0][0]    = true;
+	queue[tail++] = { 0, 0 };
+	while ( head < tail )
+	{
+		Cell cell = queue[head++];
+		if ( cell.c == gold.c && cell.r == gold.r )
+			return true;
+
+		for ( int d = 0; d < 4; ++d )
+		{
+			int c = cell.c + Compass::DX[d];
+			int r = cell.r + Compass::DY[d];
+			if ( isInBounds ( c, r ) && !blocked[c][r] && !seen[c][r] )
+			{
+				seen[c][r]    = true;
+				queue[tail++] = { c, r };
+			}
+		}
+	}
+	return false;
+}
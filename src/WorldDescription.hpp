@@ -0,0 +1,107 @@
+// ======================================================================
+// FILE:        WorldDescription.hpp
+//
+// DESCRIPTION: This file contains the world description, the parsed
+//              form of a Wumpus World File: the board dimensions and
+//              where the wumpus, the gold and the pits are. A World is
+//              built from a description, and tools that create, compare
+//              or store worlds work on descriptions without building a
+//              World at all.
+//
+// NOTES:       - Text format (a Wumpus World File):
+//
+//                  <cols> <rows>
+//                  <wumpus col> <wumpus row>
+//                  <gold col> <gold row>
+//                  <number of pits>
+//                  <pit col> <pit row>      (one line per pit)
+//
+//              - Packed format: a stream of fixed-size PackedWorld
+//                records, for suites too large to keep as one file per
+//                world.
+//
+//              - The canonical key identifies a board up to mirroring
+//                along the diagonal through the start cell (swapping
+//                columns and rows), so equal keys mean duplicate or
+//                mirrored worlds.
+// ======================================================================
+
+#ifndef WORLDDESCRIPTION_LOCK
+#define WORLDDESCRIPTION_LOCK
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+struct WorldDescription
+{
+	// The largest board, in either dimension, a World can hold
+	static const int MAX_DIMENSION = 10;
+
+	struct Cell
+	{
+		int c;
+		int r;
+	};
+
+	// A board in canonical byte form: dimensions, wumpus, gold, then
+	// one bit per cell for pits. Out of bounds features encode as 0xFF.
+	typedef std::array<unsigned char, 6 + ( MAX_DIMENSION * MAX_DIMENSION + 7 ) / 8> Encoding;
+
+	// One world of the packed format
+	struct PackedWorld
+	{
+		Encoding	encoding;
+	};
+
+	int		colDimension = 4;
+	int		rowDimension = 4;
+	Cell	wumpus       = { 0, 0 };
+	Cell	gold         = { 0, 0 };
+	std::vector<Cell>	pits;
+
+	// Parses the text format; returns false where the World constructor
+	// used to throw. Dimensions over MAX_DIMENSION are rejected.
+	bool	read		( std::istream& in );
+	void	write		( std::ostream& out ) const;
+
+	// Packed format
+	// unpack() returns false, leaving the world unchanged, for a record
+	// whose dimensions are outside 1..MAX_DIMENSION or whose wumpus or
+	// gold is neither on the board nor 0xFF. readPacked() appends the
+	// worlds of a stream, or returns false and appends nothing if the
+	// header is wrong, a record is invalid or the last one is cut short.
+	PackedWorld	pack	( void ) const;
+	bool	unpack		( const PackedWorld& packed );
+	static void	writePacked	( std::ostream& out, const std::vector<WorldDescription>& worlds );
+	static bool	readPacked	( std::istream& in, std::vector<WorldDescription>& worlds );
+
+	bool	isInBounds	( int c, int r ) const { return c >= 0 && c < colDimension && r >= 0 && r < rowDimension; }
+
+	// The checks the World applies before playing a board
+	bool	isPlayable	( void ) const
+	{
+		return colDimension > 0 && colDimension <= MAX_DIMENSION && rowDimension > 0 && rowDimension <= MAX_DIMENSION;
+	}
+
+	// The board mirrored along the diagonal through (0,0)
+	WorldDescription	transposed	( void ) const;
+
+	// Identifies the board exactly
+	uint64_t	key			( void ) const;
+
+	// The lesser encoding of the board and its mirror image
+	Encoding	canonicalEncoding	( void ) const;
+	uint64_t	canonicalKey		( void ) const;
+
+	// True if the gold can be reached from (0,0) without stepping on a
+	// pit or the wumpus
+	bool	isSolvable	( void ) const;
+
+private:
+	Encoding	encode	( void ) const;
+};
+
+#endif /* WORLDDESCRIPTION_LOCK */
@@ -0,0 +1,136 @@
+/* ======================================================================
+ * FILE:        wumpus.h
+ *
+ * DESCRIPTION: This file is the C interface to the engine, for programs
+ *              that embed it as a library (libwumpus) instead of running
+ *              the Wumpus_World executable. Worlds are loaded from
+ *              memory, agents are either built in or supplied as
+ *              function pointers, and games are played in batches that
+ *              write their results into caller-provided arrays.
+ *
+ * NOTES:       - Building the library:
+ *
+ *                  cd src && g++ -std=c++17 -O2 -shared -fPIC -pthread \
+ *                      $(ls | grep 'cpp$' | grep -v Main.cpp) -o libwumpus.so
+ *
+ *              - The interface is plain C and stable: types are only
+ *                ever extended at the end, functions are only ever
+ *                added, and WUMPUS_API_VERSION counts incompatible
+ *                changes. No C++ exception crosses it.
+ *
+ *              - A game with seed S plays exactly like the executable's
+ *                World with seed S. A suite and a registered agent may
+ *                be used by several threads at once; a suite must not
+ *                be changed while a batch is running on it.
+ * ====================================================================== */
+
+#ifndef WUMPUS_H
+#define WUMPUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined ( __GNUC__ )
+#define WUMPUS_EXPORT __attribute__ ( ( visibility ( "default" ) ) )
+#else
+#define WUMPUS_EXPORT
+#endif
+
+#define WUMPUS_API_VERSION 1
+
+/* Actions, numbered as in Agent::Action */
+enum
+{
+	WUMPUS_TURN_LEFT  = 0,
+	WUMPUS_TURN_RIGHT = 1,
+	WUMPUS_FORWARD    = 2,
+	WUMPUS_SHOOT      = 3,
+	WUMPUS_GRAB       = 4,
+	WUMPUS_CLIMB      = 5
+};
+
+/* Status of a game in wumpus_result */
+enum
+{
+	WUMPUS_OK            = 0,	/* The game was played */
+	WUMPUS_AGENT_FAILED  = 1,	/* The agent threw or returned an invalid action */
+	WUMPUS_BAD_ARGUMENT  = 2	/* No such world or agent, or a world that cannot be played */
+};
+
+typedef struct
+{
+	unsigned char	stench;
+	unsigned char	breeze;
+	unsigned char	glitter;
+	unsigned char	bump;
+	unsigned char	scream;
+} wumpus_percepts;
+
+/* An agent supplied by the caller. create() makes the state for one
+ * game, act() picks each action, destroy() frees the state. 'context' is
+ * passed to create() unchanged. With several threads, create() and
+ * destroy() may be called concurrently; each state is only ever used by
+ * one thread. */
+typedef struct
+{
+	void*	( *create )		( void* context, uint64_t seed );
+	int		( *act )		( void* state, const wumpus_percepts* percepts );
+	void	( *destroy )	( void* state );
+	void*	context;
+} wumpus_agent_callbacks;
+
+typedef struct
+{
+	int		score;
+	int		status;		/* WUMPUS_OK, WUMPUS_AGENT_FAILED or WUMPUS_BAD_ARGUMENT */
+} wumpus_result;
+
+typedef struct wumpus_suite wumpus_suite;
+
+WUMPUS_EXPORT int	wumpus_api_version	( void );
+
+/* Suites: an ordered list of worlds */
+WUMPUS_EXPORT wumpus_suite*	wumpus_suite_create		( void );
+WUMPUS_EXPORT void			wumpus_suite_destroy	( wumpus_suite* suite );
+WUMPUS_EXPORT size_t		wumpus_suite_size		( const wumpus_suite* suite );
+
+/* Appends the world in a Wumpus World File held in memory. Returns its
+ * index, or -1 if it does not parse. */
+WUMPUS_EXPORT int	wumpus_suite_add_text	( wumpus_suite* suite, const char* data, size_t length );
+
+/* Appends every world of a packed suite (see Generator.hpp) held in
+ * memory. Returns the number appended, or -1 if the data is not a
+ * packed suite, in which case nothing is appended. */
+WUMPUS_EXPORT int	wumpus_suite_add_packed	( wumpus_suite* suite, const void* data, size_t length );
+
+/* Agents: returns an id for wumpus_run_batch, or -1. Built-in names are
+ * "myai" and "random". Registered agents live as long as the library. */
+WUMPUS_EXPORT int	wumpus_agent_builtin	( const char* name );
+WUMPUS_EXPORT int	wumpus_agent_register	( const wumpus_agent_callbacks* callbacks );
+
+/* Plays 'count' games with the agent, spread over 'threads' threads (0
+ * or 1 for the calling thread only). Game i plays world worlds[i], or
+ * world i if 'worlds' is NULL, with seed seeds[i], or 0 if 'seeds' is
+ * NULL, and stores its result in results[i]. Returns the number of games
+ * with status WUMPUS_OK. If the batch itself fails, e.g. out of memory,
+ * every game is marked WUMPUS_AGENT_FAILED and 0 is returned. */
+WUMPUS_EXPORT size_t	wumpus_run_batch
+(
+	const wumpus_suite*	suite,
+	int					agent,
+	const size_t*		worlds,
+	const uint64_t*		seeds,
+	size_t				count,
+	int					threads,
+	wumpus_result*		results
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WUMPUS_H */